@@ -0,0 +1,985 @@
+/// \file benchmarks/bench_factory_register.cxx
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ * Benchmark suite for the factory_register class.
+ *
+ * Each benchmark is run for registers of 10 to --max-ids registration IDs
+ * (powers of 10) and, for the operations which may run concurrently, from 1
+ * to --max-threads threads (powers of 2). Results are printed on the
+ * standard output, one line per measurement, in CSV (default) or JSON lines
+ * format, so they can be archived and compared between releases.
+ *
+ * Usage:
+ *   bxfactories-bench_factory_register [--max-ids N] [--max-threads N]
+ *                                      [--min-time SECONDS] [--format csv|json]
+ *                                      [--filter NAME]
+ */
+
+// Standard Library:
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// This project:
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define BXBENCH_HAS_MALLINFO2 1
+#endif
+
+#include <bxfactories/bxfactories.hpp>
+#include <bxfactories/static_factory_register.hpp>
+
+namespace bench {
+
+  /// The base class of all benchmarked classes
+  class i_object
+  {
+  public:
+
+    virtual ~i_object() = default;
+
+    virtual int value() const = 0;
+
+    BXFACTORIES_FACTORY_SYSTEM_REGISTER_INTERFACE(i_object);
+
+  };
+
+  BXFACTORIES_FACTORY_SYSTEM_REGISTER_IMPLEMENTATION(bench::i_object,
+                                                     "bench::i_object/__system__")
+
+  /// A family of distinct registered classes
+  template <int N>
+  class object
+    : public i_object
+  {
+  public:
+
+    int value() const override
+    {
+      return N + _payload_[0];
+    }
+
+  private:
+
+    int _payload_[4] = {0, 1, 2, 3};
+
+  };
+
+  /// A class whose default construction precomputes a lookup grid
+  class expensive_object
+    : public i_object
+  {
+  public:
+    expensive_object()
+      : _grid_(4096)
+    {
+      for (std::size_t i = 0; i < _grid_.size(); i++) {
+        _grid_[i] = std::sin(0.001 * i) * std::exp(-0.0001 * i);
+      }
+      return;
+    }
+    int value() const override
+    {
+      return static_cast<int>(_grid_[1000] * 100);
+    }
+  private:
+    std::vector<double> _grid_;
+  };
+
+  typedef bxfactories::factory_register<i_object> register_type;
+
+  /// Number of distinct classes registered in the benchmarked registers
+  static const int nclasses = 16;
+
+  typedef void (*register_function_type)(register_type & reg_, const std::string & id_);
+  typedef void (*fetch_function_type)(const register_type & reg_, std::string & id_);
+  typedef void (*auto_register_function_type)(void * storage_, const char * id_);
+  typedef void (*auto_unregister_function_type)(void * storage_);
+
+  /// Operations on one of the distinct registered classes
+  template <int N>
+  struct class_operations
+  {
+    typedef bxfactories::_system_factory_registrator<i_object, object<N> > registrator_type;
+
+    static void register_factory(register_type & reg_, const std::string & id_)
+    {
+      reg_.register_factory<object<N> >(id_);
+      return;
+    }
+
+    static void fetch_type_id(const register_type & reg_, std::string & id_)
+    {
+      reg_.fetch_type_id<object<N> >(id_);
+      return;
+    }
+
+    static void auto_register(void * storage_, const char * id_)
+    {
+      ::new (storage_) registrator_type(id_);
+      return;
+    }
+
+    static void auto_unregister(void * storage_)
+    {
+      static_cast<registrator_type *>(storage_)->~registrator_type();
+      return;
+    }
+  };
+
+  /// Storage for an auto-registrator of any of the distinct registered classes
+  typedef std::aligned_storage<sizeof(class_operations<0>::registrator_type),
+                               alignof(class_operations<0>::registrator_type)>::type registrator_storage_type;
+
+  /// Tables of the operations on the distinct registered classes, indexed by class number
+  struct class_table
+  {
+    register_function_type      register_factory[nclasses];
+    fetch_function_type         fetch_type_id[nclasses];
+    auto_register_function_type auto_register[nclasses];
+    auto_unregister_function_type auto_unregister[nclasses];
+
+    template <int N>
+    void fill(std::integral_constant<int, N>)
+    {
+      register_factory[N] = &class_operations<N>::register_factory;
+      fetch_type_id[N] = &class_operations<N>::fetch_type_id;
+      auto_register[N] = &class_operations<N>::auto_register;
+      auto_unregister[N] = &class_operations<N>::auto_unregister;
+      this->fill(std::integral_constant<int, N + 1>());
+      return;
+    }
+
+    void fill(std::integral_constant<int, nclasses>)
+    {
+      return;
+    }
+
+    class_table()
+    {
+      this->fill(std::integral_constant<int, 0>());
+      return;
+    }
+  };
+
+  const class_table & classes()
+  {
+    static const class_table table;
+    return table;
+  }
+
+  /// Build realistic, long and namespaced, registration IDs
+  std::vector<std::string> make_ids(std::size_t count_, const std::string & prefix_ = "detector")
+  {
+    std::vector<std::string> ids;
+    ids.reserve(count_);
+    for (std::size_t i = 0; i < count_; i++) {
+      std::ostringstream id;
+      id << "bxbench::" << prefix_ << "::geometry::sector_" << (i % 97)
+         << "::module_model_" << i << "::calorimeter_block";
+      ids.push_back(id.str());
+    }
+    return ids;
+  }
+
+  /// Fill a register with given IDs
+  void fill(register_type & reg_, const std::vector<std::string> & ids_)
+  {
+    for (std::size_t i = 0; i < ids_.size(); i++) {
+      classes().register_factory[i % nclasses](reg_, ids_[i]);
+    }
+    return;
+  }
+
+  /// Benchmark configuration
+  struct config_type
+  {
+    std::size_t max_ids = 100000;
+    unsigned int max_threads = 0; // 0: hardware concurrency
+    double min_time = 0.2;        // seconds
+    std::string format = "csv";
+    std::string filter;
+  };
+
+  /// A measurement
+  struct result_type
+  {
+    std::string   name;
+    std::size_t   ids = 0;
+    unsigned int  threads = 1;
+    std::uint64_t ops = 0;
+    double        seconds = 0.0;
+    double        bytes_per_id = 0.0; ///< Heap memory per registered ID (memory benchmarks only)
+  };
+
+  void print_header(std::ostream & out_, const config_type & config_)
+  {
+    if (config_.format == "csv") {
+      out_ << "benchmark,ids,threads,ops,seconds,ns_per_op,mops_per_s,bytes_per_id" << std::endl;
+    }
+    return;
+  }
+
+  void print_result(std::ostream & out_, const config_type & config_, const result_type & result_)
+  {
+    // Time per operation, as seen by one thread:
+    const double ns_per_op = result_.ops == 0 ? 0.0 : result_.seconds * 1e9 * result_.threads / result_.ops;
+    // Aggregated throughput of all threads:
+    const double mops_per_s = result_.seconds == 0.0 ? 0.0 : result_.ops / result_.seconds * 1e-6;
+    if (config_.format == "json") {
+      out_ << "{\"benchmark\":\"" << result_.name << "\""
+           << ",\"ids\":" << result_.ids
+           << ",\"threads\":" << result_.threads
+           << ",\"ops\":" << result_.ops
+           << ",\"seconds\":" << result_.seconds
+           << ",\"ns_per_op\":" << ns_per_op
+           << ",\"mops_per_s\":" << mops_per_s
+           << ",\"bytes_per_id\":" << result_.bytes_per_id
+           << "}" << std::endl;
+    } else {
+      out_ << result_.name
+           << ',' << result_.ids
+           << ',' << result_.threads
+           << ',' << result_.ops
+           << ',' << result_.seconds
+           << ',' << ns_per_op
+           << ',' << mops_per_s
+           << ',' << result_.bytes_per_id << std::endl;
+    }
+    return;
+  }
+
+  typedef std::chrono::steady_clock clock_type;
+
+  double elapsed(const clock_type::time_point & start_)
+  {
+    return std::chrono::duration<double>(clock_type::now() - start_).count();
+  }
+
+  /// Run a pass-based benchmark on a single thread until the minimum time is reached
+  ///
+  /// The setup is not timed, the pass returns the number of operations it performed.
+  result_type run_serial(const config_type & config_,
+                         const std::function<void()> & setup_,
+                         const std::function<std::uint64_t()> & pass_)
+  {
+    result_type result;
+    while (result.seconds < config_.min_time) {
+      setup_();
+      clock_type::time_point start = clock_type::now();
+      result.ops += pass_();
+      result.seconds += elapsed(start);
+    }
+    return result;
+  }
+
+  /// Run a benchmark concurrently on several threads until the minimum time is reached
+  ///
+  /// Each thread repeatedly calls the pass with its own thread index.
+  result_type run_parallel(const config_type & config_,
+                           unsigned int nthreads_,
+                           const std::function<std::uint64_t(unsigned int)> & pass_)
+  {
+    std::atomic<bool> go{false};
+    std::atomic<bool> stop{false};
+    std::atomic<unsigned int> ready{0};
+    std::vector<std::uint64_t> ops(nthreads_, 0);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < nthreads_; t++) {
+      threads.emplace_back([&, t]() {
+          ready++;
+          while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+          std::uint64_t count = 0;
+          do {
+            count += pass_(t);
+          } while (!stop.load(std::memory_order_relaxed));
+          ops[t] = count;
+        });
+    }
+    while (ready.load() < nthreads_) std::this_thread::yield();
+    clock_type::time_point start = clock_type::now();
+    go.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::duration<double>(config_.min_time));
+    stop.store(true);
+    for (std::thread & thread : threads) thread.join();
+    result_type result;
+    result.seconds = elapsed(start);
+    result.threads = nthreads_;
+    for (std::uint64_t count : ops) result.ops += count;
+    return result;
+  }
+
+  /// Return the number of bytes allocated on the heap (0 if unknown)
+  std::size_t heap_in_use()
+  {
+#ifdef BXBENCH_HAS_MALLINFO2
+    // Large blocks are mapped apart from the main heap:
+    const struct mallinfo2 info = ::mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+  }
+
+  /// Keep the compiler from optimizing away a computed value
+  std::atomic<std::uintptr_t> sink{0};
+
+  /// Registration IDs of the distinct classes in the compile-time register
+  constexpr const char * static_ids[nclasses] = {
+    "bxbench::static::object_0",  "bxbench::static::object_1",  "bxbench::static::object_2",  "bxbench::static::object_3",
+    "bxbench::static::object_4",  "bxbench::static::object_5",  "bxbench::static::object_6",  "bxbench::static::object_7",
+    "bxbench::static::object_8",  "bxbench::static::object_9",  "bxbench::static::object_10", "bxbench::static::object_11",
+    "bxbench::static::object_12", "bxbench::static::object_13", "bxbench::static::object_14", "bxbench::static::object_15"
+  };
+
+  /// Entry of one of the distinct classes in the compile-time register
+  template <int N>
+  struct static_entry
+    : bxfactories::static_factory_entry<object<N> >
+  {
+    static constexpr const char * id()
+    {
+      return static_ids[N];
+    }
+  };
+
+  template <int... Ns>
+  struct static_register_of
+  {
+    typedef bxfactories::static_factory_register<i_object, static_entry<Ns>...> type;
+  };
+
+  /// Compile-time register of the distinct classes
+  typedef static_register_of<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15>::type static_register_type;
+
+  /// Shuffled copies of the IDs, one per thread, so threads do not walk the register in lockstep
+  std::vector<std::vector<std::string> > shuffled_ids(const std::vector<std::string> & ids_, unsigned int nthreads_)
+  {
+    std::vector<std::vector<std::string> > shuffled(nthreads_, ids_);
+    for (unsigned int t = 0; t < nthreads_; t++) {
+      std::mt19937 gen(1234 + t);
+      std::shuffle(shuffled[t].begin(), shuffled[t].end(), gen);
+    }
+    return shuffled;
+  }
+
+  class suite
+  {
+  public:
+
+    explicit suite(const config_type & config_)
+      : _config_(config_)
+    {
+      return;
+    }
+
+    void run()
+    {
+      print_header(std::cout, _config_);
+      for (std::size_t nids = 10; nids <= _config_.max_ids; nids *= 10) {
+        const std::vector<std::string> ids = make_ids(nids);
+        this->_run_registration_(ids);
+        this->_run_traced_registration_(ids);
+        this->_run_footprint_(ids);
+        this->_run_auto_registration_(ids);
+        this->_run_import_(ids);
+        this->_run_list_(ids);
+        register_type reg("bench");
+        fill(reg, ids);
+        for (unsigned int nthreads = 1; nthreads <= _config_.max_threads; nthreads *= 2) {
+          this->_run_lookups_(reg, ids, nthreads);
+        }
+      }
+      this->_run_static_();
+      this->_run_prototype_();
+      this->_run_create_set_();
+      this->_run_traced_creation_();
+      return;
+    }
+
+  private:
+
+    bool _enabled_(const std::string & name_) const
+    {
+      return _config_.filter.empty() || name_.find(_config_.filter) != std::string::npos;
+    }
+
+    void _report_(result_type result_, const std::string & name_, std::size_t nids_)
+    {
+      result_.name = name_;
+      result_.ids = nids_;
+      print_result(std::cout, _config_, result_);
+      return;
+    }
+
+    void _run_registration_(const std::vector<std::string> & ids_)
+    {
+      if (!this->_enabled_("register_factory")) return;
+      std::unique_ptr<register_type> reg;
+      result_type result = run_serial(_config_,
+                                      [&]() { reg.reset(new register_type("bench")); },
+                                      [&]() -> std::uint64_t {
+                                        fill(*reg, ids_);
+                                        return ids_.size();
+                                      });
+      reg.reset();
+      this->_report_(result, "register_factory", ids_.size());
+      return;
+    }
+
+    /// Formatter of trace events which discards the formatted lines
+    static bxfactories::trace_writer::handler_type discarding_trace_handler()
+    {
+      std::shared_ptr<std::ostringstream> line = std::make_shared<std::ostringstream>();
+      return [line](const bxfactories::trace_event & event_) {
+        line->str(std::string());
+        bxfactories::print_trace_event(*line, event_);
+      };
+    }
+
+    void _run_traced_registration_(const std::vector<std::string> & ids_)
+    {
+      if (!this->_enabled_("register_factory_traced")) return;
+      // Events are formatted in the background:
+      std::shared_ptr<bxfactories::trace_buffer> tracer = std::make_shared<bxfactories::trace_buffer>(65536);
+      bxfactories::trace_writer writer(tracer, discarding_trace_handler());
+      std::unique_ptr<register_type> reg;
+      result_type result = run_serial(_config_,
+                                      [&]() {
+                                        reg.reset(new register_type("bench"));
+                                        reg->set_tracer(tracer);
+                                      },
+                                      [&]() -> std::uint64_t {
+                                        fill(*reg, ids_);
+                                        return ids_.size();
+                                      });
+      reg.reset();
+      this->_report_(result, "register_factory_traced", ids_.size());
+      return;
+    }
+
+    void _run_footprint_(const std::vector<std::string> & ids_)
+    {
+      if (!this->_enabled_("footprint")) return;
+      // Factories with a description and a category, as documented in real registers:
+      std::vector<std::string> descriptions;
+      for (std::size_t i = 0; i < ids_.size(); i++) {
+        descriptions.push_back("Calorimeter block model #" + std::to_string(i) + " of the detector geometry");
+      }
+      static const std::string categories[4] = {"geometry", "calibration", "reconstruction", "simulation"};
+      std::unique_ptr<register_type> reg;
+      std::size_t heap = 0;
+      result_type result = run_serial(_config_,
+                                      [&]() {
+                                        reg.reset();
+                                        heap = heap_in_use();
+                                        reg.reset(new register_type("bench"));
+                                      },
+                                      [&]() -> std::uint64_t {
+                                        for (std::size_t i = 0; i < ids_.size(); i++) {
+                                          reg->register_factory(ids_[i],
+                                                                register_type::factory_type::make<object<0> >(),
+                                                                typeid(object<0>),
+                                                                descriptions[i],
+                                                                categories[i % 4]);
+                                        }
+                                        return ids_.size();
+                                      });
+      result.bytes_per_id = static_cast<double>(heap_in_use() - heap) / ids_.size();
+      reg.reset();
+      this->_report_(result, "footprint", ids_.size());
+      return;
+    }
+
+    void _run_auto_registration_(const std::vector<std::string> & ids_)
+    {
+      // Emulate the static initialization of many auto-registered classes, then the first access to the system register:
+      std::vector<registrator_storage_type> registrators(ids_.size());
+      std::size_t nregistrators = 0;
+      auto link_all = [&]() {
+        for (std::size_t i = 0; i < ids_.size(); i++) {
+          classes().auto_register[i % nclasses](&registrators[i], ids_[i].c_str());
+        }
+        nregistrators = ids_.size();
+      };
+      auto unlink_all = [&]() {
+        // Static objects are destroyed in the reverse order of their construction:
+        while (nregistrators > 0) {
+          nregistrators--;
+          classes().auto_unregister[nregistrators % nclasses](&registrators[nregistrators]);
+        }
+      };
+      if (this->_enabled_("auto_registration_link")) {
+        result_type result = run_serial(_config_,
+                                        [&]() { unlink_all(); },
+                                        [&]() -> std::uint64_t {
+                                          link_all();
+                                          return ids_.size();
+                                        });
+        unlink_all();
+        this->_report_(result, "auto_registration_link", ids_.size());
+      }
+      if (this->_enabled_("auto_registration_flush")) {
+        result_type result = run_serial(_config_,
+                                        [&]() {
+                                          unlink_all();
+                                          link_all();
+                                        },
+                                        [&]() -> std::uint64_t {
+                                          i_object::grab_system_factory_register();
+                                          return ids_.size();
+                                        });
+        unlink_all();
+        this->_report_(result, "auto_registration_flush", ids_.size());
+      }
+      return;
+    }
+
+    void _run_import_(const std::vector<std::string> & ids_)
+    {
+      register_type source("source");
+      fill(source, ids_);
+      std::unique_ptr<register_type> target;
+      if (this->_enabled_("import")) {
+        result_type result = run_serial(_config_,
+                                        [&]() { target.reset(new register_type("target")); },
+                                        [&]() -> std::uint64_t {
+                                          target->import(source);
+                                          return ids_.size();
+                                        });
+        this->_report_(result, "import", ids_.size());
+      }
+      if (this->_enabled_("import_some")) {
+        // Import one half of the IDs:
+        std::set<std::string> selection;
+        for (std::size_t i = 0; i < ids_.size(); i += 2) selection.insert(ids_[i]);
+        result_type result = run_serial(_config_,
+                                        [&]() { target.reset(new register_type("target")); },
+                                        [&]() -> std::uint64_t {
+                                          target->import_some(source, selection);
+                                          return selection.size();
+                                        });
+        this->_report_(result, "import_some", ids_.size());
+      }
+      if (this->_enabled_("import_prefix")) {
+        // Import the IDs of one sector (IDs of sectors 1, 10..19 share the prefix):
+        const std::string prefix = "bxbench::detector::geometry::sector_1";
+        std::size_t nselected = 0;
+        for (const std::string & id : ids_) nselected += id.compare(0, prefix.size(), prefix) == 0;
+        result_type result = run_serial(_config_,
+                                        [&]() { target.reset(new register_type("target")); },
+                                        [&]() -> std::uint64_t {
+                                          target->import_prefix(source, prefix);
+                                          return nselected;
+                                        });
+        this->_report_(result, "import_prefix", ids_.size());
+      }
+      if (this->_enabled_("import_overwrite")) {
+        // Replace all the factories of a register:
+        result_type result = run_serial(_config_,
+                                        [&]() {
+                                          target.reset(new register_type("target"));
+                                          target->import(source);
+                                        },
+                                        [&]() -> std::uint64_t {
+                                          target->import(source, register_type::import_overwrite);
+                                          return ids_.size();
+                                        });
+        this->_report_(result, "import_overwrite", ids_.size());
+      }
+      if (this->_enabled_("overlay")) {
+        // Restrict the source register with a few denied IDs and one local factory, without copying it:
+        const std::vector<std::string> local_ids = make_ids(1, "local");
+        result_type result = run_serial(_config_,
+                                        []() {},
+                                        [&]() -> std::uint64_t {
+                                          const std::uint64_t noverlays = 100;
+                                          for (std::uint64_t i = 0; i < noverlays; i++) {
+                                            bxfactories::factory_overlay<i_object> overlay(source, "overlay");
+                                            for (std::size_t j = 0; j < ids_.size() && j < 10; j++) overlay.deny(ids_[j]);
+                                            overlay.register_factory<object<0> >(local_ids[0]);
+                                            sink.fetch_add(overlay.has(ids_.back()), std::memory_order_relaxed);
+                                          }
+                                          return noverlays;
+                                        });
+        this->_report_(result, "overlay", ids_.size());
+      }
+      return;
+    }
+
+    void _run_list_(const std::vector<std::string> & ids_)
+    {
+      register_type reg("bench");
+      fill(reg, ids_);
+      if (this->_enabled_("list_of_factory_ids")) {
+        std::set<std::string> listed;
+        result_type result = run_serial(_config_,
+                                        [&]() { listed.clear(); },
+                                        [&]() -> std::uint64_t {
+                                          reg.list_of_factory_ids(listed, true);
+                                          return listed.size();
+                                        });
+        this->_report_(result, "list_of_factory_ids", ids_.size());
+      }
+      if (this->_enabled_("records")) {
+        // Walk all IDs, copying only the pointers to the records:
+        result_type result = run_serial(_config_,
+                                        []() {},
+                                        [&]() -> std::uint64_t {
+                                          std::size_t length = 0;
+                                          for (const register_type::factory_record_type & record : reg.records()) {
+                                            length += record.type_id.size();
+                                          }
+                                          sink.fetch_add(length, std::memory_order_relaxed);
+                                          return reg.size();
+                                        });
+        this->_report_(result, "records", ids_.size());
+      }
+      if (this->_enabled_("records_with_prefix")) {
+        // Walk the IDs of one sector, copying only the pointers to the records:
+        const std::string prefix = "bxbench::detector::geometry::sector_1::";
+        result_type result = run_serial(_config_,
+                                        []() {},
+                                        [&]() -> std::uint64_t {
+                                          std::size_t length = 0;
+                                          std::uint64_t count = 0;
+                                          for (const register_type::factory_record_type & record : reg.records_with_prefix(prefix)) {
+                                            length += record.type_id.size();
+                                            count++;
+                                          }
+                                          sink.fetch_add(length, std::memory_order_relaxed);
+                                          // Empty queries are accounted as one operation:
+                                          return std::max<std::uint64_t>(count, 1);
+                                        });
+        this->_report_(result, "records_with_prefix", ids_.size());
+      }
+      return;
+    }
+
+    void _run_lookups_(const register_type & reg_, const std::vector<std::string> & ids_, unsigned int nthreads_)
+    {
+      const std::vector<std::vector<std::string> > hits = shuffled_ids(ids_, nthreads_);
+      const std::vector<std::vector<std::string> > misses = shuffled_ids(make_ids(ids_.size(), "unknown"), nthreads_);
+      std::vector<std::vector<register_type::factory_handle_type> > handles(nthreads_);
+      for (unsigned int t = 0; t < nthreads_; t++) {
+        for (const std::string & id : hits[t]) handles[t].push_back(reg_.resolve(id));
+      }
+      // Lookups are done by batches of 1000 between two checks of the stop flag:
+      const std::size_t nbatch = 1000;
+      // Position of each thread in its list of IDs (one per cache line):
+      struct alignas(64) cursor_type { std::size_t value = 0; };
+      std::vector<cursor_type> cursors(nthreads_);
+      auto run = [&](const std::string & name_,
+                     const std::function<std::uintptr_t(unsigned int, std::size_t)> & op_) {
+        if (!this->_enabled_(name_)) return;
+        std::fill(cursors.begin(), cursors.end(), cursor_type());
+        result_type result = run_parallel(_config_, nthreads_, [&](unsigned int t_) -> std::uint64_t {
+            std::size_t & cursor = cursors[t_].value;
+            std::uintptr_t acc = 0;
+            for (std::size_t i = 0; i < nbatch; i++) {
+              acc += op_(t_, cursor);
+              if (++cursor == ids_.size()) cursor = 0;
+            }
+            sink.fetch_add(acc, std::memory_order_relaxed);
+            return nbatch;
+          });
+        this->_report_(result, name_, ids_.size());
+      };
+      run("has", [&](unsigned int t_, std::size_t i_) -> std::uintptr_t {
+          return reg_.has(hits[t_][i_]);
+        });
+      run("has_miss", [&](unsigned int t_, std::size_t i_) -> std::uintptr_t {
+          return reg_.has(misses[t_][i_]);
+        });
+      run("find_miss", [&](unsigned int t_, std::size_t i_) -> std::uintptr_t {
+          return reinterpret_cast<std::uintptr_t>(reg_.find(misses[t_][i_]));
+        });
+      run("get", [&](unsigned int t_, std::size_t i_) -> std::uintptr_t {
+          return reinterpret_cast<std::uintptr_t>(&reg_.get(hits[t_][i_]));
+        });
+      run("get_record", [&](unsigned int t_, std::size_t i_) -> std::uintptr_t {
+          return reg_.get_record(hits[t_][i_]).type_size;
+        });
+      run("create_by_id", [&](unsigned int t_, std::size_t i_) -> std::uintptr_t {
+          std::unique_ptr<i_object> obj(reg_.get(hits[t_][i_])());
+          return static_cast<std::uintptr_t>(obj->value());
+        });
+      run("create_by_handle", [&](unsigned int t_, std::size_t i_) -> std::uintptr_t {
+          std::unique_ptr<i_object> obj(reg_.create(handles[t_][i_]));
+          return static_cast<std::uintptr_t>(obj->value());
+        });
+      run("fetch_type_id", [&](unsigned int t_, std::size_t i_) -> std::uintptr_t {
+          std::string id;
+          classes().fetch_type_id[(i_ + t_) % nclasses](reg_, id);
+          return id.size();
+        });
+      return;
+    }
+
+    void _run_static_()
+    {
+      // The same closed set of classes, in the compile-time and in a runtime register:
+      const static_register_type static_reg;
+      register_type reg("bench");
+      static_reg.export_factories(reg);
+      std::vector<std::string> ids;
+      std::vector<register_type::factory_handle_type> handles;
+      for (std::size_t i = 0; i < static_register_type::size(); i++) {
+        ids.push_back(static_register_type::id_at(i));
+        handles.push_back(reg.resolve(ids.back()));
+      }
+      const std::vector<std::vector<std::string> > shuffled = shuffled_ids(std::vector<std::string>(ids.begin(), ids.end()), 1);
+      // The same IDs as string literals, and as factory IDs hashed once:
+      std::vector<const char *> literals;
+      std::vector<bxfactories::factory_id> fids;
+      for (const std::string & id : shuffled[0]) {
+        const char * literal = static_ids[static_register_type::find_index(id)];
+        literals.push_back(literal);
+        fids.push_back(bxfactories::factory_id(literal, std::strlen(literal)));
+      }
+      const std::size_t nbatch = 1000;
+      auto run = [&](const std::string & name_, const std::function<std::uintptr_t(std::size_t)> & op_) {
+        if (!this->_enabled_(name_)) return;
+        std::size_t cursor = 0;
+        result_type result = run_serial(_config_,
+                                        []() {},
+                                        [&]() -> std::uint64_t {
+                                          std::uintptr_t acc = 0;
+                                          for (std::size_t i = 0; i < nbatch; i++) {
+                                            acc += op_(cursor);
+                                            if (++cursor == ids.size()) cursor = 0;
+                                          }
+                                          sink.fetch_add(acc, std::memory_order_relaxed);
+                                          return nbatch;
+                                        });
+        this->_report_(result, name_, ids.size());
+      };
+      run("has_runtime", [&](std::size_t i_) -> std::uintptr_t {
+          return reg.has(shuffled[0][i_]);
+        });
+      run("has_static", [&](std::size_t i_) -> std::uintptr_t {
+          return static_reg.has(shuffled[0][i_]);
+        });
+      run("has_literal_runtime", [&](std::size_t i_) -> std::uintptr_t {
+          return reg.has(literals[i_]);
+        });
+      run("has_fid_runtime", [&](std::size_t i_) -> std::uintptr_t {
+          return reg.has(fids[i_]);
+        });
+      run("create_by_fid_runtime", [&](std::size_t i_) -> std::uintptr_t {
+          std::unique_ptr<i_object> obj(reg.get(fids[i_])());
+          return static_cast<std::uintptr_t>(obj->value());
+        });
+      run("try_create_runtime", [&](std::size_t i_) -> std::uintptr_t {
+          std::unique_ptr<i_object> obj(reg.try_create(shuffled[0][i_]));
+          return static_cast<std::uintptr_t>(obj->value());
+        });
+      run("try_create_static", [&](std::size_t i_) -> std::uintptr_t {
+          std::unique_ptr<i_object> obj(static_reg.try_create(shuffled[0][i_]));
+          return static_cast<std::uintptr_t>(obj->value());
+        });
+      run("create_by_handle_runtime", [&](std::size_t i_) -> std::uintptr_t {
+          std::unique_ptr<i_object> obj(reg.create(handles[i_]));
+          return static_cast<std::uintptr_t>(obj->value());
+        });
+      run("create_by_index_static", [&](std::size_t i_) -> std::uintptr_t {
+          std::unique_ptr<i_object> obj(static_reg.create(i_));
+          return static_cast<std::uintptr_t>(obj->value());
+        });
+      run("create_by_constant_index_static", [&](std::size_t) -> std::uintptr_t {
+          std::unique_ptr<i_object> obj(static_register_type::create<static_register_type::index_of("bxbench::static::object_7")>());
+          return static_cast<std::uintptr_t>(obj->value());
+        });
+      return;
+    }
+
+    void _run_prototype_()
+    {
+      register_type reg("bench");
+      reg.register_factory<expensive_object>("bxbench::expensive::constructed");
+      reg.register_prototype("bxbench::expensive::prototype", std::make_shared<const expensive_object>());
+      const register_type::factory_handle_type constructed = reg.resolve("bxbench::expensive::constructed");
+      const register_type::factory_handle_type prototype = reg.resolve("bxbench::expensive::prototype");
+      const std::size_t nbatch = 100;
+      auto run = [&](const std::string & name_, const register_type::factory_handle_type & handle_) {
+        if (!this->_enabled_(name_)) return;
+        result_type result = run_serial(_config_,
+                                        []() {},
+                                        [&]() -> std::uint64_t {
+                                          std::uintptr_t acc = 0;
+                                          for (std::size_t i = 0; i < nbatch; i++) {
+                                            std::unique_ptr<i_object> obj(reg.create(handle_));
+                                            acc += static_cast<std::uintptr_t>(obj->value());
+                                          }
+                                          sink.fetch_add(acc, std::memory_order_relaxed);
+                                          return nbatch;
+                                        });
+        this->_report_(result, name_, 1);
+      };
+      run("create_expensive_constructed", constructed);
+      run("create_expensive_prototype", prototype);
+      return;
+    }
+
+    void _run_create_set_()
+    {
+      // A job configuration: light objects of distinct classes, one heavy object out of four:
+      const std::size_t nobjects = 1000;
+      const std::vector<std::string> light_ids = make_ids(nobjects, "setup");
+      register_type reg("bench");
+      fill(reg, light_ids);
+      reg.register_factory<expensive_object>("bxbench::setup::expensive");
+      std::vector<std::string> ids;
+      for (std::size_t i = 0; i < nobjects; i++) {
+        ids.push_back(i % 4 == 0 ? std::string("bxbench::setup::expensive") : light_ids[i]);
+      }
+      if (this->_enabled_("create_set_serial")) {
+        result_type result = run_serial(_config_,
+                                        []() {},
+                                        [&]() -> std::uint64_t {
+                                          // The whole set is alive at once, as after a job setup:
+                                          std::vector<std::unique_ptr<i_object> > objects;
+                                          objects.reserve(ids.size());
+                                          for (const std::string & id : ids) {
+                                            objects.emplace_back(reg.get(id)());
+                                          }
+                                          std::uintptr_t acc = 0;
+                                          for (const std::unique_ptr<i_object> & obj : objects) {
+                                            acc += static_cast<std::uintptr_t>(obj->value());
+                                          }
+                                          sink.fetch_add(acc, std::memory_order_relaxed);
+                                          return ids.size();
+                                        });
+        this->_report_(result, "create_set_serial", reg.size());
+      }
+      if (!this->_enabled_("create_set")) return;
+      for (unsigned int nthreads = 2; nthreads <= _config_.max_threads; nthreads *= 2) {
+        // The calling thread takes part in the creation:
+        bxfactories::thread_pool pool(nthreads - 1);
+        result_type result = run_serial(_config_,
+                                        []() {},
+                                        [&]() -> std::uint64_t {
+                                          std::uintptr_t acc = 0;
+                                          std::vector<register_type::creation_result_type> objects = reg.create_set(ids, pool);
+                                          for (const register_type::creation_result_type & created : objects) {
+                                            std::unique_ptr<i_object> obj(created.object);
+                                            acc += static_cast<std::uintptr_t>(obj->value());
+                                          }
+                                          sink.fetch_add(acc, std::memory_order_relaxed);
+                                          return ids.size();
+                                        });
+        // Wall-clock time: the throughput column gives the speedup over create_set_serial
+        result.threads = nthreads;
+        this->_report_(result, "create_set", reg.size());
+      }
+      return;
+    }
+
+    void _run_traced_creation_()
+    {
+      const std::vector<std::string> ids = make_ids(1000, "traced");
+      register_type reg("bench");
+      fill(reg, ids);
+      std::vector<register_type::factory_handle_type> handles;
+      for (const std::string & id : ids) handles.push_back(reg.resolve(id));
+      std::shared_ptr<bxfactories::trace_buffer> tracer = std::make_shared<bxfactories::trace_buffer>(65536);
+      bxfactories::trace_writer writer(tracer, discarding_trace_handler());
+      auto run = [&](const std::string & name_, bool trace_creations_) {
+        if (!this->_enabled_(name_)) return;
+        reg.set_tracer(tracer, trace_creations_);
+        result_type result = run_serial(_config_,
+                                        []() {},
+                                        [&]() -> std::uint64_t {
+                                          std::uintptr_t acc = 0;
+                                          for (const register_type::factory_handle_type & handle : handles) {
+                                            std::unique_ptr<i_object> obj(reg.create(handle));
+                                            acc += static_cast<std::uintptr_t>(obj->value());
+                                          }
+                                          sink.fetch_add(acc, std::memory_order_relaxed);
+                                          return handles.size();
+                                        });
+        this->_report_(result, name_, ids.size());
+      };
+      run("create_untraced", false);
+      run("create_traced", true);
+      reg.set_tracer(nullptr);
+      return;
+    }
+
+  private:
+
+    config_type _config_;
+
+  };
+
+  config_type parse_arguments(int argc_, char ** argv_)
+  {
+    config_type config;
+    for (int iarg = 1; iarg < argc_; iarg++) {
+      const std::string arg = argv_[iarg];
+      if (arg == "--help") {
+        std::cout << "Usage: " << argv_[0]
+                  << " [--max-ids N] [--max-threads N] [--min-time SECONDS] [--format csv|json] [--filter NAME]"
+                  << std::endl;
+        std::exit(EXIT_SUCCESS);
+      }
+      if (iarg + 1 == argc_) {
+        throw std::invalid_argument("Missing value for option '" + arg + "' !");
+      }
+      const std::string value = argv_[++iarg];
+      if (arg == "--max-ids") {
+        config.max_ids = std::stoul(value);
+      } else if (arg == "--max-threads") {
+        config.max_threads = static_cast<unsigned int>(std::stoul(value));
+      } else if (arg == "--min-time") {
+        config.min_time = std::stod(value);
+      } else if (arg == "--format") {
+        if (value != "csv" && value != "json") {
+          throw std::invalid_argument("Invalid output format '" + value + "' !");
+        }
+        config.format = value;
+      } else if (arg == "--filter") {
+        config.filter = value;
+      } else {
+        throw std::invalid_argument("Invalid option '" + arg + "' !");
+      }
+    }
+    if (config.max_threads == 0) {
+      config.max_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return config;
+  }
+
+} // end of namespace bench
+
+int main(int argc_, char ** argv_)
+{
+  int error_code = EXIT_SUCCESS;
+  try {
+    bench::suite(bench::parse_arguments(argc_, argv_)).run();
+  } catch (std::exception & error) {
+    std::cerr << "[error] " << error.what() << std::endl;
+    error_code = EXIT_FAILURE;
+  } catch (...) {
+    std::cerr << "[error] " << "Unexpected error!" << std::endl;
+    error_code = EXIT_FAILURE;
+  }
+  return error_code;
+}
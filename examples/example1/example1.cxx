@@ -187,11 +187,16 @@ int main(void)
                    "System factory for classes inherited from example::i_runner: ");
       std::clog << std::endl;
     
-      std::unique_ptr<examples::i_runner> runner1(sysReg.get("examples::foo_runner")());
-      std::unique_ptr<examples::i_runner> runner2(sysReg.get("examples::foo_runner")());
-      std::unique_ptr<examples::i_runner> runner3(sysReg.get("more_examples::bar_runner")());
-      std::unique_ptr<examples::i_runner> runner4(sysReg.get("more_examples::baz_runner")());
-      std::unique_ptr<examples::i_runner> runner5(sysReg.get("more_examples::bar_runner")());
+      // Constant factory IDs are hashed at compile time:
+      using namespace bxfactories::literals;
+      constexpr bxfactories::factory_id foo_id = "examples::foo_runner"_fid;
+      constexpr bxfactories::factory_id bar_id = "more_examples::bar_runner"_fid;
+      constexpr bxfactories::factory_id baz_id = "more_examples::baz_runner"_fid;
+      std::unique_ptr<examples::i_runner> runner1(sysReg.get(foo_id)());
+      std::unique_ptr<examples::i_runner> runner2(sysReg.get(foo_id)());
+      std::unique_ptr<examples::i_runner> runner3(sysReg.get(bar_id)());
+      std::unique_ptr<examples::i_runner> runner4(sysReg.get(baz_id)());
+      std::unique_ptr<examples::i_runner> runner5(sysReg.get(bar_id)());
       std::clog << std::endl;
     
       runner1->run();
@@ -205,16 +210,19 @@ int main(void)
     {
       std::clog << std::endl << "================================================================" << std::endl;
       std::clog << "[log] Using a specific factory register, limited to only a few classes..." << std::endl;
-      ::bxfactories::factory_register<examples::i_runner> myReg("Limited factory: ");
-      auto sysReg = BXFACTORIES_FACTORY_GET_SYSTEM_REGISTER(examples::i_runner);
-      // Import some of the object factories registered in the system register (because we like them!)
-      myReg.import_some(sysReg,
-                        std::set<std::string>({
-                            "more_examples::bar_runner",
-                              "more_examples::baz_runner"}));
+      // The overlay refers to the system register, no factory is copied:
+      ::bxfactories::factory_overlay<examples::i_runner> myReg(BXFACTORIES_FACTORY_GET_SYSTEM_REGISTER(examples::i_runner),
+                                                               "Limited factory");
+      // Allow some of the object factories registered in the system register (because we like them!)
+      myReg.allow("more_examples::bar_runner");
+      myReg.allow("more_examples::baz_runner");
       // Manual registration of the "special_runner" class (because we like it too!):
       myReg.register_factory<more_examples::special_runner>("special", "A special runner");
-      myReg.print(std::clog, "[log] ", "My own limited register: ");
+      std::set<std::string> visible_ids;
+      myReg.list_of_factory_ids(visible_ids);
+      for (const std::string & id : visible_ids) {
+        std::clog << "[log] My own limited overlay provides '" << id << "'" << std::endl;
+      }
       std::clog << std::endl;
 
       std::list<std::string> runner_type_ids({{"examples::foo_runner",
@@ -225,9 +233,10 @@ int main(void)
               "more_examples::dummy_runner"}});
       // Attempt to instantiate and run some objects with the 'runner' interface:
       for (auto runner_type_id : runner_type_ids) {
-        if (myReg.has(runner_type_id)) {
-          std::clog << "[log] Runner with registration ID '" << runner_type_id << "' is to be instantiated." << std::endl;
-          std::unique_ptr<examples::i_runner> runner(myReg.get(runner_type_id)());
+        // A single lookup, which neither allocates nor throws if the ID is unknown:
+        std::unique_ptr<examples::i_runner> runner(myReg.try_create(runner_type_id));
+        if (runner) {
+          std::clog << "[log] Runner with registration ID '" << runner_type_id << "' has been instantiated." << std::endl;
           runner->run();
         } else {
           std::cerr << "[warning] Runner with registration ID '" << runner_type_id << "' does not exist in this register." << std::endl;
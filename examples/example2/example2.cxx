@@ -0,0 +1,64 @@
+
+// Standard Library:
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <stdexcept>
+
+// This project:
+#include "shape.hpp"
+
+namespace examples {
+
+  // We implement the system registration mechanism
+  BXFACTORIES_FACTORY_SYSTEM_REGISTER_IMPLEMENTATION(examples::i_shape,
+                                                     "examples::i_shape/__system__")
+
+  /// Return the number of shapes registered in the system register
+  std::size_t number_of_shapes()
+  {
+    std::set<std::string> ids;
+    i_shape::get_system_factory_register().list_of_factory_ids(ids);
+    return ids.size();
+  }
+
+} // end of namespace examples
+
+int main(int argc_, char ** argv_)
+{
+  int error_code = EXIT_SUCCESS;
+  try {
+    // The manifest maps the IDs of the shapes to the plugin library which provides them:
+    std::shared_ptr<bxfactories::plugin_manifest> plugins = std::make_shared<bxfactories::plugin_manifest>();
+    plugins->load(argc_ > 1 ? argv_[1] : "example2.manifest");
+
+    examples::i_shape::factory_register_type & shapeReg = examples::i_shape::grab_system_factory_register();
+    shapeReg.set_plugin_manifest(plugins);
+    std::clog << "[log] Number of registered shapes before any lookup: " << examples::number_of_shapes() << std::endl;
+
+    {
+      // The first lookup of a shape loads the plugin library:
+      std::unique_ptr<examples::i_shape> square(shapeReg.try_create("examples::shapes::square"));
+      std::unique_ptr<examples::i_shape> disk(shapeReg.try_create("examples::shapes::disk"));
+      if (!square || !disk) {
+        throw std::logic_error("Shapes are not available!");
+      }
+      std::clog << "[log] Square surface = " << square->surface() << std::endl;
+      std::clog << "[log] Disk surface = " << disk->surface() << std::endl;
+      std::clog << "[log] Number of registered shapes: " << examples::number_of_shapes() << std::endl;
+      // A shape which is not provided by the plugin is not found:
+      std::clog << "[log] Has 'examples::shapes::triangle': " << std::boolalpha << shapeReg.has("examples::shapes::triangle") << std::endl;
+    }
+
+    // All shapes are destroyed: the plugin library can be unloaded, its classes are unregistered.
+    plugins->unload();
+    std::clog << "[log] Number of registered shapes after unloading: " << examples::number_of_shapes() << std::endl;
+
+  } catch (std::exception & error) {
+    std::cerr << "[error] " << error.what() << std::endl;
+    error_code = EXIT_FAILURE;
+  }
+  return error_code;
+}
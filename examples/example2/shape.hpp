@@ -0,0 +1,26 @@
+#ifndef EXAMPLES_SHAPE_HPP
+#define EXAMPLES_SHAPE_HPP
+
+// This project:
+#include <bxfactories/bxfactories.hpp>
+
+namespace examples {
+
+  /// A base interface whose derived classes are provided by a plugin library
+  class i_shape
+  {
+  public:
+
+    virtual ~i_shape() = default;
+
+    /// Return the surface of the shape
+    virtual double surface() const = 0;
+
+    // We declare a system registration mechanism for classes inherited from this base interface class
+    BXFACTORIES_FACTORY_SYSTEM_REGISTER_INTERFACE(i_shape);
+
+  };
+
+} // end of namespace examples
+
+#endif // EXAMPLES_SHAPE_HPP
@@ -0,0 +1,54 @@
+// This plugin library is not linked to the example2 executable:
+// its classes are registered in the system register of the
+// i_shape interface when it is loaded on demand.
+
+// This project:
+#include "shape.hpp"
+
+namespace examples {
+
+  namespace shapes {
+
+    /// A square
+    class square
+      : public i_shape
+    {
+    public:
+
+      double surface() const override
+      {
+        return 4.0;
+      }
+
+      BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_INTERFACE(examples::i_shape,
+                                                             examples::shapes::square)
+
+    };
+
+    BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_IMPLEMENTATION(examples::i_shape,
+                                                                examples::shapes::square,
+                                                                "examples::shapes::square")
+
+    /// A disk
+    class disk
+      : public i_shape
+    {
+    public:
+
+      double surface() const override
+      {
+        return 3.14159;
+      }
+
+      BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_INTERFACE(examples::i_shape,
+                                                             examples::shapes::disk)
+
+    };
+
+    BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_IMPLEMENTATION(examples::i_shape,
+                                                                examples::shapes::disk,
+                                                                "examples::shapes::disk")
+
+  } // end of namespace shapes
+
+} // end of namespace examples
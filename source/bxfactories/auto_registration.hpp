@@ -0,0 +1,240 @@
+/// \file bxfactories/auto_registration.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_AUTO_REGISTRATION_HPP
+#define BXFACTORIES_AUTO_REGISTRATION_HPP
+
+// Standard Library:
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// This project:
+#include <bxfactories/factory_id.hpp>
+
+namespace bxfactories {
+
+  namespace detail {
+
+    /// Registration ID of a string literal, referred to in place with its hash
+    template <std::size_t N>
+    constexpr factory_id auto_registration_id(const char (&id_)[N])
+    {
+      return factory_id(id_, N - 1);
+    }
+
+    /// Registration ID in a character buffer, copied by the registrator
+    template <std::size_t N>
+    std::string auto_registration_id(char (&id_)[N])
+    {
+      return std::string(id_);
+    }
+
+    /// Registration ID built at run time, copied by the registrator
+    inline std::string auto_registration_id(const std::string & id_)
+    {
+      return id_;
+    }
+
+    /// \brief Deferred registration of a class in the system register of a base class
+    template <class RegisterType>
+    struct auto_registration_node
+    {
+      typedef void (*apply_type)(RegisterType & register_, const factory_id & type_id_);
+
+      enum state_type {
+        state_pending = 0,    ///< Linked in the list of pending registrations
+        state_registered = 1, ///< Registered in the system register
+        state_failed = 2      ///< Rejected by the system register (duplicated ID...)
+      };
+
+      factory_id               type_id;           ///< Registration ID (static storage) and its hash
+      apply_type               apply = nullptr;   ///< Function registering the class
+      auto_registration_node * next = nullptr;    ///< Next pending registration
+      std::atomic<int>         state{state_pending};
+    };
+
+    /*! \brief Pending registrations in the system register of a base class
+     *
+     *  Auto-registrators are static objects: they only push a node on a
+     *  lock-free intrusive list, without any allocation nor locking, so
+     *  that the static initialization costs nearly nothing. Pending
+     *  registrations are performed on the next access to the system
+     *  register, which is materialized on first access. Classes from
+     *  libraries loaded later are so registered on the next access too.
+     *
+     *  All members are constant-initialized: the list can be used before
+     *  the dynamic initialization of any translation unit.
+     */
+    template <class BaseType>
+    class auto_registration_list
+    {
+    public:
+
+      typedef typename BaseType::factory_register_type register_type;
+      typedef auto_registration_node<register_type>    node_type;
+
+      /// Add a pending registration
+      static void link(node_type & node_)
+      {
+        node_type * head = _head_.load(std::memory_order_relaxed);
+        do {
+          node_.next = head;
+        } while (!_head_.compare_exchange_weak(head, &node_, std::memory_order_release, std::memory_order_relaxed));
+        return;
+      }
+
+      /// Remove a registration: unlink it if it is pending, otherwise unregister it from the system register if it is alive
+      static void unlink(node_type & node_)
+      {
+        {
+          std::lock_guard<std::mutex> lock(_mutex_);
+          const int state = node_.state.load(std::memory_order_relaxed);
+          // A rejected registration must not remove the factory registered under the same ID:
+          if (state == node_type::state_failed) return;
+          if (state == node_type::state_pending) {
+            node_type * expected = &node_;
+            if (!_head_.compare_exchange_strong(expected, node_.next, std::memory_order_acq_rel)) {
+              // Other nodes have been pushed meanwhile, only the head is modified without locking:
+              node_type * previous = expected;
+              while (previous->next != &node_) previous = previous->next;
+              previous->next = node_.next;
+            }
+            return;
+          }
+        }
+        register_type * system_register = _register_.load(std::memory_order_acquire);
+        // A frozen register keeps its factories until its own destruction:
+        if (system_register == nullptr || system_register->is_frozen()) return;
+        // The plugin libraries of the register are not looked up:
+        if (system_register->_find_record_(node_.type_id.view(), node_.type_id.hash()) != nullptr) {
+          system_register->unregister_factory(std::string(node_.type_id.data(), node_.type_id.size()));
+        }
+        return;
+      }
+
+      /// Perform the pending registrations, if any
+      static void flush(register_type & register_)
+      {
+        if (_head_.load(std::memory_order_acquire) == nullptr) return;
+        std::string errors;
+        {
+          std::lock_guard<std::mutex> lock(_mutex_);
+          node_type * pending = _head_.exchange(nullptr, std::memory_order_acq_rel);
+          // Registrations are performed in the order of the static initialization:
+          node_type * ordered = nullptr;
+          while (pending != nullptr) {
+            node_type * next = pending->next;
+            pending->next = ordered;
+            ordered = pending;
+            pending = next;
+          }
+          for (node_type * node = ordered; node != nullptr; node = node->next) {
+            // Other registrations are performed anyway:
+            try {
+              node->apply(register_, node->type_id);
+              node->state.store(node_type::state_registered, std::memory_order_relaxed);
+              continue;
+            } catch (std::exception & error) {
+              errors += errors.empty() ? "" : " ; ";
+              errors += error.what();
+            } catch (...) {
+              errors += errors.empty() ? "" : " ; ";
+              errors += "Unexpected exception while registering class ID '" + std::string(node->type_id.data(), node->type_id.size()) + "'";
+            }
+            node->state.store(node_type::state_failed, std::memory_order_relaxed);
+          }
+        }
+        if (!errors.empty()) {
+          throw std::logic_error(errors);
+        }
+        return;
+      }
+
+      /// Perform the pending registrations in the system register, if it is alive
+      static void flush_attached()
+      {
+        register_type * system_register = _register_.load(std::memory_order_acquire);
+        if (system_register != nullptr) flush(*system_register);
+        return;
+      }
+
+      /// Set the system register (null when it is destroyed)
+      static void attach(register_type * register_)
+      {
+        _register_.store(register_, std::memory_order_release);
+        return;
+      }
+
+    private:
+
+      static std::atomic<node_type *>     _head_;     ///< Pending registrations (last linked first)
+      static std::mutex                   _mutex_;    ///< Mutex serializing flushes and unlinks
+      static std::atomic<register_type *> _register_; ///< The system register (null if not alive)
+
+    };
+
+    template <class BaseType>
+    std::atomic<typename auto_registration_list<BaseType>::node_type *> auto_registration_list<BaseType>::_head_{nullptr};
+
+    template <class BaseType>
+    std::mutex auto_registration_list<BaseType>::_mutex_;
+
+    template <class BaseType>
+    std::atomic<typename auto_registration_list<BaseType>::register_type *> auto_registration_list<BaseType>::_register_{nullptr};
+
+    /*! \brief Holder of the system register of a base class
+     *
+     *  The system register is a local static object which is materialized
+     *  on first access. Its pending registrations are performed on each
+     *  access, and auto-registrators destroyed after it do not refer to it.
+     */
+    template <class BaseType>
+    class system_register_holder
+    {
+    public:
+
+      typedef typename BaseType::factory_register_type register_type;
+
+      /// Constructor
+      explicit system_register_holder(const std::string & label_)
+        : _register_(label_, 0)
+      {
+        // Libraries loaded on demand by the register auto-register their classes:
+        _register_._flush_pending_ = &auto_registration_list<BaseType>::flush_attached;
+        auto_registration_list<BaseType>::attach(&_register_);
+        return;
+      }
+
+      /// Destructor
+      ~system_register_holder()
+      {
+        auto_registration_list<BaseType>::attach(nullptr);
+        return;
+      }
+
+      /// Return the system register, after the pending registrations
+      register_type & grab()
+      {
+        auto_registration_list<BaseType>::flush(_register_);
+        return _register_;
+      }
+
+    private:
+
+      register_type _register_; ///< The system register
+
+    };
+
+  } // end of namespace detail
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_AUTO_REGISTRATION_HPP
@@ -5,6 +5,12 @@
 // This project:
 #include <bxfactories/version.hpp>
 #include <bxfactories/factory.hpp>
+#include <bxfactories/factory_id.hpp>
+#include <bxfactories/factory_pool.hpp>
+#include <bxfactories/thread_pool.hpp>
+#include <bxfactories/factory_trace.hpp>
+#include <bxfactories/factory_overlay.hpp>
+#include <bxfactories/static_factory_register.hpp>
 #include <bxfactories/factory_macros.hpp>
 
 #endif // BXFACTORIES_BXFACTORIES_HPP
@@ -0,0 +1,133 @@
+/// \file bxfactories/chunked_array.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_CHUNKED_ARRAY_HPP
+#define BXFACTORIES_CHUNKED_ARRAY_HPP
+
+// Standard Library:
+#include <atomic>
+#include <cstddef>
+
+namespace bxfactories {
+
+  namespace detail {
+
+    /*! \brief Growable array with stable element addresses
+     *
+     *  Elements are stored in chunks of geometrically increasing sizes
+     *  which are never moved nor released before the array itself.
+     *  Elements can be accessed by one modifying thread (the owner
+     *  serializes modifications) while other threads read them: an
+     *  element is published by the release store of the size which
+     *  follows its construction.
+     */
+    template <class ElementType>
+    class chunked_array
+    {
+    public:
+
+      typedef ElementType element_type;
+
+      /// Default constructor
+      chunked_array() = default;
+
+      /// Not copyable
+      chunked_array(const chunked_array &) = delete;
+
+      /// Not assignable
+      chunked_array & operator=(const chunked_array &) = delete;
+
+      /// Destructor
+      ~chunked_array()
+      {
+        for (std::size_t k = 0; k < max_chunks; k++) {
+          delete [] _chunks_[k].load(std::memory_order_relaxed);
+        }
+        return;
+      }
+
+      /// Return the number of published elements
+      std::size_t size() const
+      {
+        return _size_.load(std::memory_order_acquire);
+      }
+
+      /// Return a mutable reference to the element at given position (no bound check)
+      element_type & operator[](std::size_t i_)
+      {
+        std::size_t offset;
+        const unsigned int k = _locate_(i_, offset);
+        return _chunks_[k].load(std::memory_order_acquire)[offset];
+      }
+
+      /// Return a const reference to the element at given position (no bound check)
+      const element_type & operator[](std::size_t i_) const
+      {
+        std::size_t offset;
+        const unsigned int k = _locate_(i_, offset);
+        return _chunks_[k].load(std::memory_order_acquire)[offset];
+      }
+
+      /// Publish a new default constructed element and return a reference to it
+      ///
+      /// The caller may initialize the element before publishing it by
+      /// passing a setup functor, which is called before the size is updated.
+      template <class Setup>
+      element_type & emplace_back(Setup setup_)
+      {
+        const std::size_t i = _size_.load(std::memory_order_relaxed);
+        std::size_t offset;
+        const unsigned int k = _locate_(i, offset);
+        element_type * chunk = _chunks_[k].load(std::memory_order_relaxed);
+        if (chunk == nullptr) {
+          chunk = new element_type[first_chunk_size << k];
+          _chunks_[k].store(chunk, std::memory_order_release);
+        }
+        element_type & element = chunk[offset];
+        setup_(element);
+        _size_.store(i + 1, std::memory_order_release);
+        return element;
+      }
+
+    private:
+
+      static const std::size_t first_chunk_size = 64;
+      static const std::size_t max_chunks = 48;
+
+      /// Return the chunk of an element and its offset in the chunk
+      static unsigned int _locate_(std::size_t i_, std::size_t & offset_)
+      {
+        // Chunk k stores the first_chunk_size * 2^k elements from first_chunk_size * (2^k - 1):
+        const std::size_t j = i_ / first_chunk_size + 1;
+        unsigned int k = 0;
+#if defined(__GNUC__)
+        k = 63 - __builtin_clzll(static_cast<unsigned long long>(j));
+#else
+        for (std::size_t r = j; r > 1; r >>= 1) k++;
+#endif
+        offset_ = i_ - first_chunk_size * ((std::size_t(1) << k) - 1);
+        return k;
+      }
+
+    private:
+
+      std::atomic<element_type *> _chunks_[max_chunks] = {}; ///< Chunks of elements
+      std::atomic<std::size_t>    _size_{0};                 ///< Number of published elements
+
+    };
+
+    template <class ElementType>
+    const std::size_t chunked_array<ElementType>::first_chunk_size;
+
+    template <class ElementType>
+    const std::size_t chunked_array<ElementType>::max_chunks;
+
+  } // end of namespace detail
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_CHUNKED_ARRAY_HPP
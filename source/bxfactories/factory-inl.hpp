@@ -1,7 +1,7 @@
 /// \file bxfactories/factory-inl.hpp
 /* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
  * Creation date : 2020-03-18
- * Last modified : 2020-03-18
+ * Last modified : 2026-10-17
  *
  */
 
@@ -11,142 +11,959 @@
 // Implementation section for the factory_register class
 namespace bxfactories {
 
-  // template <typename BaseType>
-  // factory_register<BaseType>::factory_register()
+  // template <typename BaseType, typename... Args>
+  // factory_register<BaseType, Args...>::factory_register()
   //   : _label_()
   // {
   //   return;
   // }
 
-  template <typename BaseType>
-  factory_register<BaseType>::factory_register(const std::string & label_,
+  template <typename BaseType, typename... Args>
+  factory_register<BaseType, Args...>::factory_register(const std::string & label_,
                                                const unsigned int flags_)
     : _label_(label_)
   {
-    if (flags_ & init_trace) _trace_ = true;
+    if (flags_ & init_trace) this->set_tracer(detail::default_trace_buffer(), flags_ & init_trace_creations);
     return;
   }
 
-  template <typename BaseType>
-  factory_register<BaseType>::~factory_register()
+  template <typename BaseType, typename... Args>
+  factory_register<BaseType, Args...>::factory_register(const factory_register & other_)
+    : base_factory_register()
   {
-    this->clear();
+    std::lock_guard<std::mutex> other_lock(other_._mutex_);
+    _tracer_ = other_._tracer_;
+    _creation_tracer_ = other_._creation_tracer_;
+    _label_ = other_._label_;
+    this->_copy_from_(other_);
     return;
   }
 
-  template <typename BaseType>
-  const std::string & factory_register<BaseType>::get_label() const
+  template <typename BaseType, typename... Args>
+  factory_register<BaseType, Args...>::~factory_register()
+  {
+    std::lock_guard<std::mutex> lock(_mutex_);
+    this->_clear_();
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  factory_register<BaseType, Args...> &
+  factory_register<BaseType, Args...>::operator=(const factory_register & other_)
+  {
+    if (this != &other_) {
+      std::lock(_mutex_, other_._mutex_);
+      std::lock_guard<std::mutex> lock(_mutex_, std::adopt_lock);
+      std::lock_guard<std::mutex> other_lock(other_._mutex_, std::adopt_lock);
+      _frozen_.store(nullptr, std::memory_order_release);
+      _sealed_.store(false, std::memory_order_release);
+      _frozen_index_.reset();
+      this->_clear_();
+      _retired_.clear();
+      // No record refers to the interned strings anymore:
+      _ids_.clear();
+      _texts_.clear();
+      _tracer_ = other_._tracer_;
+      _creation_tracer_ = other_._creation_tracer_;
+      _label_ = other_._label_;
+      this->_copy_from_(other_);
+    }
+    return *this;
+  }
+
+  template <typename BaseType, typename... Args>
+  const std::string & factory_register<BaseType, Args...>::get_label() const
   {
     return _label_;
   }
 
-  template <typename BaseType>
-  void factory_register<BaseType>::set_label(const std::string & label_)
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::set_label(const std::string & label_)
   {
     _label_ = label_;
     return;
   }
 
-  template <typename BaseType>
-  void factory_register<BaseType>::list_of_factory_ids(std::set<std::string> & ids_, bool clear_) const
+  template <typename BaseType, typename... Args>
+  const std::shared_ptr<trace_buffer> & factory_register<BaseType, Args...>::get_tracer() const
+  {
+    return _tracer_;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::set_tracer(const std::shared_ptr<trace_buffer> & tracer_, bool trace_creations_)
+  {
+    _tracer_ = tracer_;
+    _creation_tracer_ = trace_creations_ ? _tracer_.get() : nullptr;
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_trace_(trace_operation operation_, const id_view_type & id_) const
+  {
+    _tracer_->record(operation_, _label_, id_);
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  const std::shared_ptr<plugin_manifest> & factory_register<BaseType, Args...>::get_plugin_manifest() const
+  {
+    return _plugins_;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::set_plugin_manifest(const std::shared_ptr<plugin_manifest> & manifest_)
+  {
+    if (manifest_ && _flush_pending_ == nullptr) {
+      std::ostringstream error_message;
+      error_message << "bxfactory::factory_register<>::set_plugin_manifest(...): "
+                    << "Register '" << _label_ << "' is not a system register, plugin libraries cannot register classes in it !";
+      throw std::logic_error(error_message.str());
+    }
+    _plugins_ = manifest_;
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::list_of_factory_ids(std::set<std::string> & ids_, bool clear_) const
   {
     if (clear_) ids_.clear(); // make sure the set is empty before to feed it
+    std::lock_guard<std::mutex> lock(_mutex_);
     for (typename factory_map_type::const_iterator i = _registered_.begin();
          i != _registered_.end();
          ++i) {
-      ids_.insert(i->first);
+      // IDs are walked in order, appending is done in constant time:
+      ids_.insert(ids_.end(), std::string(i->first.data(), i->first.size()));
     }
     return;
   }
 
-  template <typename BaseType>
-  bool factory_register<BaseType>::has(const std::string & id_) const
+  template <typename BaseType, typename... Args>
+  std::size_t factory_register<BaseType, Args...>::size() const
   {
-    return _registered_.find(id_) != _registered_.end();
+    return _size_.load(std::memory_order_acquire);
   }
 
-  template <typename BaseType>
-  void factory_register<BaseType>::clear()
+  template <typename BaseType, typename... Args>
+  std::uint64_t factory_register<BaseType, Args...>::get_version() const
   {
-    for (typename factory_map_type::iterator i = _registered_.begin();
-         i != _registered_.end();
+    return _version_.load(std::memory_order_acquire);
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::records_view_type
+  factory_register<BaseType, Args...>::lock_records() const
+  {
+    std::unique_lock<std::mutex> lock(_mutex_);
+    typename factory_map_type::const_iterator first = _registered_.begin();
+    typename factory_map_type::const_iterator last = _registered_.end();
+    return records_view_type(std::move(lock), first, last);
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::factory_record_type *
+  factory_register<BaseType, Args...>::_find_record_(const id_view_type & id_) const
+  {
+    return this->_find_record_(id_, detail::hash_id(id_));
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::factory_record_type *
+  factory_register<BaseType, Args...>::_find_record_(const id_view_type & id_, std::uint64_t hash_) const
+  {
+    const factory_frozen_index_type * frozen = _frozen_.load(std::memory_order_acquire);
+    if (frozen != nullptr) {
+      return frozen->find(id_, hash_);
+    }
+    return _index_.find(id_, hash_);
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::factory_record_type *
+  factory_register<BaseType, Args...>::_lookup_(const id_view_type & id_) const
+  {
+    return this->_lookup_(id_, detail::hash_id(id_));
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::factory_record_type *
+  factory_register<BaseType, Args...>::_lookup_(const id_view_type & id_, std::uint64_t hash_) const
+  {
+    factory_record_type * found = this->_find_record_(id_, hash_);
+    if (found != nullptr || !_plugins_) return found;
+    // The classes of a library could not be registered in a frozen register:
+    if (_sealed_.load(std::memory_order_acquire)) return nullptr;
+    return this->_load_plugin_(id_, hash_);
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::factory_record_type &
+  factory_register<BaseType, Args...>::_get_record_(const id_view_type & id_, std::uint64_t hash_, const char * where_) const
+  {
+    factory_record_type * found = this->_lookup_(id_, hash_);
+    if (found == nullptr) {
+      std::ostringstream error_message;
+      error_message << "bxfactory::factory_register<>::" << where_ << "(...): " << "Class ID '" << id_ << "' is not registered !";
+      throw std::logic_error(error_message.str());
+    }
+    return *found;
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::factory_record_type *
+  factory_register<BaseType, Args...>::_load_plugin_(const id_view_type & id_, std::uint64_t hash_) const
+  {
+    bool failed = false;
+    if (!_plugins_->load_for(id_, &failed)) {
+      if (failed && _tracer_) this->_trace_(trace_operation::plugin_failed, id_);
+      return nullptr;
+    }
+    if (_tracer_) this->_trace_(trace_operation::plugin_loaded, id_);
+    // The static auto-registrators of the library have only linked their registrations:
+    if (_flush_pending_ != nullptr) _flush_pending_();
+    return this->_find_record_(id_, hash_);
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_intern_(factory_record_type & record_)
+  {
+    record_.type_id = _ids_.intern(record_.type_id);
+    record_.description = _texts_.intern(record_.description);
+    // Records of a category share its interned name:
+    typename category_index_type::const_iterator found = _categories_.find(record_.category);
+    record_.category = found != _categories_.end() ? found->first : _texts_.intern(record_.category);
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_copy_from_(const factory_register & other_)
+  {
+    // Records are stored in the same handle slots, with the same generations,
+    // as in the other register, so that handles can be used with copies:
+    const std::size_t nslots = other_._slots_.size();
+    while (_slots_.size() < nslots) {
+      _slots_.emplace_back([](handle_slot_type &) {});
+    }
+    _free_slots_ = other_._free_slots_;
+    for (std::size_t i = 0; i < _slots_.size(); i++) {
+      handle_slot_type & slot = _slots_[i];
+      slot.record.store(nullptr, std::memory_order_release);
+      if (i < nslots) {
+        slot.generation.store(other_._slots_[i].generation.load(std::memory_order_relaxed), std::memory_order_release);
+      } else {
+        std::uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+        if (generation == 0) generation = 1;
+        slot.generation.store(generation, std::memory_order_release);
+        _free_slots_.push_back(static_cast<std::uint32_t>(i));
+      }
+    }
+    _index_.reserve(other_._records_.size());
+    for (typename factory_record_list_type::const_iterator i = other_._records_.begin();
+         i != other_._records_.end();
          ++i) {
-      if (i->second.fact != nullptr) {
-        if (_trace_) {
-          std::cerr << "[trace] bxfactory::factory_register<>::clear(): " << "Destroying registered allocator/functor '" << i->first << "'" << std::endl;
+      typename factory_record_list_type::iterator inserted = _records_.insert(_records_.end(), *i);
+      factory_record_type & record = *inserted;
+      this->_intern_(record);
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+      this->_instrument_(record);
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+      _slots_[record.handle.slot].record.store(&record, std::memory_order_release);
+      _registered_[record.type_id] = inserted;
+      this->_index_type_(record);
+      this->_index_category_(record);
+      _index_.insert(record.type_id, &record, record.type_hash);
+    }
+    _size_.store(_registered_.size(), std::memory_order_release);
+    _version_.fetch_add(1, std::memory_order_release);
+    if (other_.is_frozen()) {
+      this->_freeze_();
+    }
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_index_type_(const factory_record_type & record_)
+  {
+    if (record_.tinfo == nullptr) return;
+    std::vector<const factory_record_type *> & records = _types_[std::type_index(*record_.tinfo)];
+    records.insert(std::upper_bound(records.begin(), records.end(), &record_,
+                                    [](const factory_record_type * lhs_, const factory_record_type * rhs_) {
+                                      return lhs_->type_id < rhs_->type_id;
+                                    }),
+                   &record_);
+    this->_reindex_type_(*record_.tinfo);
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_unindex_type_(const factory_record_type & record_)
+  {
+    if (record_.tinfo == nullptr) return;
+    typename type_index_type::iterator found = _types_.find(std::type_index(*record_.tinfo));
+    if (found == _types_.end()) return;
+    std::vector<const factory_record_type *> & records = found->second;
+    records.erase(std::remove(records.begin(), records.end(), &record_), records.end());
+    if (records.empty()) _types_.erase(found);
+    this->_reindex_type_(*record_.tinfo);
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_index_category_(const factory_record_type & record_)
+  {
+    std::vector<const factory_record_type *> & records = _categories_[record_.category];
+    records.insert(std::upper_bound(records.begin(), records.end(), &record_,
+                                    [](const factory_record_type * lhs_, const factory_record_type * rhs_) {
+                                      return lhs_->type_id < rhs_->type_id;
+                                    }),
+                   &record_);
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_unindex_category_(const factory_record_type & record_)
+  {
+    typename category_index_type::iterator found = _categories_.find(record_.category);
+    if (found == _categories_.end()) return;
+    std::vector<const factory_record_type *> & records = found->second;
+    records.erase(std::remove(records.begin(), records.end(), &record_), records.end());
+    if (records.empty()) _categories_.erase(found);
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_reindex_type_(const std::type_info & tinfo_)
+  {
+    typename type_index_type::const_iterator found = _types_.find(std::type_index(tinfo_));
+    const factory_record_type * first = found == _types_.end() ? nullptr : found->second.front();
+    const id_view_type name(tinfo_.name());
+    const factory_record_type * indexed = _type_index_.find(name);
+    if (indexed != nullptr && !(*indexed->tinfo == tinfo_)) {
+      // Another class with the same name (local classes from distinct
+      // translation units) owns the entry, fetch_type_id() uses the slow path:
+      _type_name_clashes_ = true;
+      return;
+    }
+    if (indexed == first) return;
+    if (indexed != nullptr) _type_index_.erase(name);
+    if (first != nullptr) {
+      _type_index_.insert(name, first);
+    } else if (_type_name_clashes_) {
+      // Hand the entry over to another class with the same name, if any:
+      for (typename type_index_type::const_iterator i = _types_.begin(); i != _types_.end(); ++i) {
+        if (name == id_view_type(i->first.name())) {
+          _type_index_.insert(name, i->second.front());
+          break;
         }
       }
     }
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  const typename factory_register<BaseType, Args...>::factory_record_type *
+  factory_register<BaseType, Args...>::_find_record_(const factory_handle_type & handle_) const
+  {
+    if (handle_.slot >= _slots_.size()) return nullptr;
+    const handle_slot_type & slot = _slots_[handle_.slot];
+    if (slot.generation.load(std::memory_order_acquire) != handle_.generation) return nullptr;
+    const factory_record_type * record = slot.record.load(std::memory_order_acquire);
+    // The slot may have been released, then reused, in the meantime:
+    if (slot.generation.load(std::memory_order_acquire) != handle_.generation) return nullptr;
+    return record;
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::factory_handle_type
+  factory_register<BaseType, Args...>::_acquire_slot_(factory_record_type * record_)
+  {
+    factory_handle_type handle;
+    if (_free_slots_.empty()) {
+      handle.slot = static_cast<std::uint32_t>(_slots_.size());
+      _slots_.emplace_back([record_](handle_slot_type & slot_) {
+          slot_.record.store(record_, std::memory_order_relaxed);
+        });
+    } else {
+      handle.slot = _free_slots_.back();
+      _free_slots_.pop_back();
+      _slots_[handle.slot].record.store(record_, std::memory_order_release);
+    }
+    handle.generation = _slots_[handle.slot].generation.load(std::memory_order_relaxed);
+    return handle;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_release_slot_(const factory_handle_type & handle_)
+  {
+    handle_slot_type & slot = _slots_[handle_.slot];
+    std::uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+    // Generation 0 is reserved for null handles:
+    if (generation == 0) generation = 1;
+    slot.generation.store(generation, std::memory_order_release);
+    slot.record.store(nullptr, std::memory_order_release);
+    _free_slots_.push_back(handle_.slot);
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::prefix_view_type
+  factory_register<BaseType, Args...>::lock_records_with_prefix(const std::string & prefix_) const
+  {
+    std::unique_lock<std::mutex> lock(_mutex_);
+    // IDs with a given prefix are contiguous in the dictionary, up to the
+    // first ID not less than the successor of the prefix:
+    std::string bound(prefix_);
+    while (!bound.empty() && static_cast<unsigned char>(bound[bound.size() - 1]) == 0xFF) {
+      bound.erase(bound.size() - 1);
+    }
+    typename factory_map_type::const_iterator last = _registered_.end();
+    if (!bound.empty()) {
+      bound[bound.size() - 1] = static_cast<char>(static_cast<unsigned char>(bound[bound.size() - 1]) + 1);
+      last = _registered_.lower_bound(bound);
+    }
+    typename factory_map_type::const_iterator first = _registered_.lower_bound(prefix_);
+    return prefix_view_type(std::move(lock), first, last);
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::category_view_type
+  factory_register<BaseType, Args...>::lock_records_in_category(const std::string & category_) const
+  {
+    static const std::vector<const factory_record_type *> no_records;
+    std::unique_lock<std::mutex> lock(_mutex_);
+    typename category_index_type::const_iterator found = _categories_.find(category_);
+    const std::vector<const factory_record_type *> & records = found == _categories_.end() ? no_records : found->second;
+    return category_view_type(std::move(lock), records.begin(), records.end());
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::record_snapshot_type
+  factory_register<BaseType, Args...>::records() const
+  {
+    // The view, and its lock, only live while the pointers are copied:
+    return record_snapshot_type(this->lock_records());
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::record_snapshot_type
+  factory_register<BaseType, Args...>::records_with_prefix(const std::string & prefix_) const
+  {
+    return record_snapshot_type(this->lock_records_with_prefix(prefix_));
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::record_snapshot_type
+  factory_register<BaseType, Args...>::records_in_category(const std::string & category_) const
+  {
+    return record_snapshot_type(this->lock_records_in_category(category_));
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::list_of_categories(std::set<std::string> & categories_, bool clear_) const
+  {
+    if (clear_) categories_.clear();
+    std::lock_guard<std::mutex> lock(_mutex_);
+    for (typename category_index_type::const_iterator i = _categories_.begin();
+         i != _categories_.end();
+         ++i) {
+      categories_.insert(std::string(i->first.data(), i->first.size()));
+    }
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  bool factory_register<BaseType, Args...>::has(const id_view_type & id_) const
+  {
+    return this->_lookup_(id_) != nullptr;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::clear()
+  {
+    std::lock_guard<std::mutex> lock(_mutex_);
+    this->_check_not_frozen_("clear");
+    this->_clear_();
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_clear_()
+  {
+    for (typename factory_record_list_type::iterator i = _records_.begin();
+         i != _records_.end();
+         ++i) {
+      if (_tracer_) this->_trace_(trace_operation::cleared, i->type_id);
+      this->_release_slot_(i->handle);
+    }
+    _index_.clear();
+    _type_index_.clear();
+    _types_.clear();
+    _categories_.clear();
+    if (!_registered_.empty()) _version_.fetch_add(1, std::memory_order_release);
+    _size_.store(0, std::memory_order_release);
     _registered_.clear();
+    // Concurrent lookups may still use the records:
+    _retired_.splice(_retired_.end(), _records_);
     return;
   }
 
-  template <typename BaseType>
-  void factory_register<BaseType>::reset()
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::reset()
   {
-    this->clear();
+    {
+      std::lock_guard<std::mutex> lock(_mutex_);
+      _frozen_.store(nullptr, std::memory_order_release);
+      _sealed_.store(false, std::memory_order_release);
+      _frozen_index_.reset();
+      this->_clear_();
+    }
     _label_.clear();
-    _trace_ = false;
+    _tracer_.reset();
+    _creation_tracer_ = nullptr;
     return;
   }
 
-  template <typename BaseType>
-  typename factory_register<BaseType>::factory_type &
-  factory_register<BaseType>::grab(const std::string & id_)
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::compact()
   {
-    typename factory_map_type::iterator found = _registered_.find(id_);
-    if (found == _registered_.end()) {
+    std::lock_guard<std::mutex> lock(_mutex_);
+    _retired_.clear();
+    // The live strings are interned again in fresh arenas, the old ones are
+    // kept until the dictionary and the indexes refer to the new strings:
+    detail::string_arena old_ids;
+    detail::string_arena old_texts;
+    _ids_.swap(old_ids);
+    _texts_.swap(old_texts);
+    _registered_.clear();
+    _categories_.clear();
+    _index_.clear();
+    _index_.reserve(_records_.size());
+    for (typename factory_record_list_type::iterator i = _records_.begin();
+         i != _records_.end();
+         ++i) {
+      factory_record_type & record = *i;
+      this->_intern_(record);
+      _registered_.emplace(record.type_id, i);
+      this->_index_category_(record);
+      _index_.insert(record.type_id, &record, record.type_hash);
+    }
+    _index_.reclaim();
+    _type_index_.reclaim();
+    if (_sealed_.load(std::memory_order_relaxed)) {
+      _frozen_.store(nullptr, std::memory_order_release);
+      _frozen_index_.reset();
+      this->_freeze_();
+    }
+    _version_.fetch_add(1, std::memory_order_release);
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  bool factory_register<BaseType, Args...>::freeze(std::size_t max_attempts_)
+  {
+    std::lock_guard<std::mutex> lock(_mutex_);
+    if (_sealed_.load(std::memory_order_relaxed)) return _frozen_index_ != nullptr;
+    return this->_freeze_(max_attempts_);
+  }
+
+  template <typename BaseType, typename... Args>
+  bool factory_register<BaseType, Args...>::is_frozen() const
+  {
+    return _sealed_.load(std::memory_order_acquire);
+  }
+
+  template <typename BaseType, typename... Args>
+  bool factory_register<BaseType, Args...>::is_perfectly_indexed() const
+  {
+    return _frozen_.load(std::memory_order_acquire) != nullptr;
+  }
+
+  template <typename BaseType, typename... Args>
+  bool factory_register<BaseType, Args...>::_freeze_(std::size_t max_attempts_)
+  {
+    std::vector<typename factory_frozen_index_type::entry_type> entries;
+    entries.reserve(_records_.size());
+    for (typename factory_record_list_type::iterator i = _records_.begin();
+         i != _records_.end();
+         ++i) {
+      entries.push_back(std::make_pair(id_view_type(i->type_id), &*i));
+    }
+    std::unique_ptr<const factory_frozen_index_type> frozen_index(new factory_frozen_index_type(entries, max_attempts_));
+    _sealed_.store(true, std::memory_order_release);
+    if (!frozen_index->valid()) {
+      // Lookups keep on using the mutable index, which is never modified anymore:
+      return false;
+    }
+    _frozen_index_ = std::move(frozen_index);
+    _frozen_.store(_frozen_index_.get(), std::memory_order_release);
+    return true;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_check_not_frozen_(const char * where_) const
+  {
+    if (_sealed_.load(std::memory_order_relaxed)) {
       std::ostringstream error_message;
-      error_message << "bxfactory::factory_register<>::grab(...): " << "Class ID '" << id_ << "' is not registered !";
+      error_message << "bxfactory::factory_register<>::" << where_ << "(...): " << "Register '" << _label_ << "' is frozen !";
       throw std::logic_error(error_message.str());
     }
-    return found->second.fact;
+    return;
   }
 
-  template <typename BaseType>
-  const typename factory_register<BaseType>::factory_type &
-  factory_register<BaseType>::get(const std::string & id_) const
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::factory_type &
+  factory_register<BaseType, Args...>::grab(const id_view_type & id_)
   {
-    typename factory_map_type::const_iterator found = _registered_.find(id_);
-    if (found == _registered_.end()) {
+    return this->_get_record_(id_, detail::hash_id(id_), "grab").fact;
+  }
+
+  template <typename BaseType, typename... Args>
+  const typename factory_register<BaseType, Args...>::factory_type &
+  factory_register<BaseType, Args...>::get(const id_view_type & id_) const
+  {
+    return this->_get_record_(id_, detail::hash_id(id_), "get").fact;
+  }
+
+  template <typename BaseType, typename... Args>
+  const typename factory_register<BaseType, Args...>::factory_record_type &
+  factory_register<BaseType, Args...>::get_record(const id_view_type & id_) const
+  {
+    return this->_get_record_(id_, detail::hash_id(id_), "get_record");
+  }
+  
+  template <typename BaseType, typename... Args>
+  const typename factory_register<BaseType, Args...>::factory_record_type *
+  factory_register<BaseType, Args...>::find(const id_view_type & id_) const
+  {
+    return this->_lookup_(id_);
+  }
+
+  template <typename BaseType, typename... Args>
+  const typename factory_register<BaseType, Args...>::factory_type *
+  factory_register<BaseType, Args...>::try_get(const id_view_type & id_) const
+  {
+    const factory_record_type * found = this->_lookup_(id_);
+    return found == nullptr ? nullptr : &found->fact;
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::base_type *
+  factory_register<BaseType, Args...>::try_create(const id_view_type & id_, Args... args_) const
+  {
+    const factory_record_type * found = this->_lookup_(id_);
+    if (found == nullptr) return nullptr;
+    base_type * object = found->fact(std::forward<Args>(args_)...);
+    if (_creation_tracer_ != nullptr) _creation_tracer_->record(trace_operation::created, _label_, found->type_id);
+    return object;
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::factory_handle_type
+  factory_register<BaseType, Args...>::resolve(const id_view_type & id_) const
+  {
+    return this->_get_record_(id_, detail::hash_id(id_), "resolve").handle;
+  }
+
+  template <typename BaseType, typename... Args>
+  bool factory_register<BaseType, Args...>::has(const factory_id & id_) const
+  {
+    return this->_lookup_(id_.view(), id_.hash()) != nullptr;
+  }
+
+  template <typename BaseType, typename... Args>
+  const typename factory_register<BaseType, Args...>::factory_type &
+  factory_register<BaseType, Args...>::get(const factory_id & id_) const
+  {
+    return this->_get_record_(id_.view(), id_.hash(), "get").fact;
+  }
+
+  template <typename BaseType, typename... Args>
+  const typename factory_register<BaseType, Args...>::factory_record_type &
+  factory_register<BaseType, Args...>::get_record(const factory_id & id_) const
+  {
+    return this->_get_record_(id_.view(), id_.hash(), "get_record");
+  }
+
+  template <typename BaseType, typename... Args>
+  const typename factory_register<BaseType, Args...>::factory_record_type *
+  factory_register<BaseType, Args...>::find(const factory_id & id_) const
+  {
+    return this->_lookup_(id_.view(), id_.hash());
+  }
+
+  template <typename BaseType, typename... Args>
+  const typename factory_register<BaseType, Args...>::factory_type *
+  factory_register<BaseType, Args...>::try_get(const factory_id & id_) const
+  {
+    const factory_record_type * found = this->_lookup_(id_.view(), id_.hash());
+    return found == nullptr ? nullptr : &found->fact;
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::base_type *
+  factory_register<BaseType, Args...>::try_create(const factory_id & id_, Args... args_) const
+  {
+    const factory_record_type * found = this->_lookup_(id_.view(), id_.hash());
+    if (found == nullptr) return nullptr;
+    base_type * object = found->fact(std::forward<Args>(args_)...);
+    if (_creation_tracer_ != nullptr) _creation_tracer_->record(trace_operation::created, _label_, found->type_id);
+    return object;
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::factory_handle_type
+  factory_register<BaseType, Args...>::resolve(const factory_id & id_) const
+  {
+    return this->_get_record_(id_.view(), id_.hash(), "resolve").handle;
+  }
+
+  template <typename BaseType, typename... Args>
+  bool factory_register<BaseType, Args...>::has(const factory_handle_type & handle_) const
+  {
+    return this->_find_record_(handle_) != nullptr;
+  }
+
+  template <typename BaseType, typename... Args>
+  const typename factory_register<BaseType, Args...>::factory_type &
+  factory_register<BaseType, Args...>::get(const factory_handle_type & handle_) const
+  {
+    const factory_record_type * found = this->_find_record_(handle_);
+    if (found == nullptr) {
       std::ostringstream error_message;
-      error_message << "bxfactory::factory_register<>::get(...): " << "Class ID '" << id_ << "' is not registered !";
+      error_message << "bxfactory::factory_register<>::get(...): " << "Invalid handle to slot #" << handle_.slot << " !";
       throw std::logic_error(error_message.str());
     }
-    return found->second.fact;
+    return found->fact;
   }
 
-  template <typename BaseType>
-  const typename factory_register<BaseType>::factory_record_type &
-  factory_register<BaseType>::get_record(const std::string & id_) const
+  template <typename BaseType, typename... Args>
+  const typename factory_register<BaseType, Args...>::factory_record_type &
+  factory_register<BaseType, Args...>::get_record(const factory_handle_type & handle_) const
   {
-    typename factory_map_type::const_iterator found = _registered_.find(id_);
-    if (found == _registered_.end()) {
+    const factory_record_type * found = this->_find_record_(handle_);
+    if (found == nullptr) {
       std::ostringstream error_message;
-      error_message << "bxfactory::factory_register<>::get_record(...): " << "Class ID '" << id_ << "' is not registered !";
+      error_message << "bxfactory::factory_register<>::get_record(...): " << "Invalid handle to slot #" << handle_.slot << " !";
       throw std::logic_error(error_message.str());
     }
-    return found->second;
+    return *found;
   }
-  
-  template <typename BaseType>
-  bool factory_register<BaseType>::fetch_type_id(const std::type_info & tinfo_, std::string & id_) const
+
+  template <typename BaseType, typename... Args>
+  const typename factory_register<BaseType, Args...>::factory_record_type *
+  factory_register<BaseType, Args...>::find(const factory_handle_type & handle_) const
   {
-    id_.clear();
-    for (typename factory_map_type::const_iterator i = _registered_.begin();
-         i != _registered_.end();
-         ++i) {
-      if (&tinfo_ == i->second.tinfo) {
-        id_ = i->first;
-        return true;
+    return this->_find_record_(handle_);
+  }
+
+  template <typename BaseType, typename... Args>
+  const typename factory_register<BaseType, Args...>::factory_type *
+  factory_register<BaseType, Args...>::try_get(const factory_handle_type & handle_) const
+  {
+    const factory_record_type * found = this->_find_record_(handle_);
+    return found == nullptr ? nullptr : &found->fact;
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::base_type *
+  factory_register<BaseType, Args...>::create(const factory_handle_type & handle_, Args... args_) const
+  {
+    const factory_record_type * found = this->_find_record_(handle_);
+    if (found == nullptr) {
+      std::ostringstream error_message;
+      error_message << "bxfactory::factory_register<>::create(...): " << "Invalid handle to slot #" << handle_.slot << " !";
+      throw std::logic_error(error_message.str());
+    }
+    base_type * object = found->fact(std::forward<Args>(args_)...);
+    if (_creation_tracer_ != nullptr) _creation_tracer_->record(trace_operation::created, _label_, found->type_id);
+    return object;
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::base_type *
+  factory_register<BaseType, Args...>::try_create(const factory_handle_type & handle_, Args... args_) const
+  {
+    const factory_record_type * found = this->_find_record_(handle_);
+    if (found == nullptr) return nullptr;
+    base_type * object = found->fact(std::forward<Args>(args_)...);
+    if (_creation_tracer_ != nullptr) _creation_tracer_->record(trace_operation::created, _label_, found->type_id);
+    return object;
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::factory_batch_type
+  factory_register<BaseType, Args...>::create_batch(const id_view_type & id_, std::size_t count_, Args... args_) const
+  {
+    return this->create_batch(this->resolve(id_), count_, std::forward<Args>(args_)...);
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::factory_batch_type
+  factory_register<BaseType, Args...>::create_batch(const factory_handle_type & handle_, std::size_t count_, Args... args_) const
+  {
+    static_assert(std::has_virtual_destructor<base_type>::value,
+                  "bxfactories::factory_register<>::create_batch: the base class has no virtual destructor!");
+    const factory_record_type & record = this->get_record(handle_);
+    factory_batch_type batch;
+    if (count_ == 0) return batch;
+    if (record.construct == nullptr) {
+      // The layout of the class is unknown, objects are allocated one by one:
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+      batch._stats_ = record.stats;
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+      batch._objects_.reserve(count_);
+      for (std::size_t i = 0; i < count_; i++) {
+        batch._objects_.push_back(record.fact(detail::batch_argument<Args>::pass(args_)...));
+        if (_creation_tracer_ != nullptr) _creation_tracer_->record(trace_operation::created, _label_, record.type_id);
       }
+      return batch;
     }
-    return false;
-  }                    
- 
-  template <typename BaseType>
+    std::size_t stride = 0;
+    char * slot = batch._allocate_(count_, record.type_size, record.type_alignment, stride);
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+    batch._stats_ = record.stats;
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+    for (std::size_t i = 0; i < count_; i++, slot += stride) {
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+      const detail::factory_stats::clock_type::time_point start = detail::factory_stats::clock_type::now();
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+      // On failure, the batch destroys the objects already constructed:
+      batch._objects_.push_back(record.construct(slot, detail::batch_argument<Args>::pass(args_)...));
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+      record.stats->on_created(detail::factory_stats::elapsed_ns(start));
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+      if (_creation_tracer_ != nullptr) _creation_tracer_->record(trace_operation::created, _label_, record.type_id);
+    }
+    return batch;
+  }
+
+  template <typename BaseType, typename... Args>
+  std::vector<typename factory_register<BaseType, Args...>::creation_result_type>
+  factory_register<BaseType, Args...>::create_set(const std::vector<std::string> & ids_,
+                                                  thread_pool & pool_,
+                                                  Args... args_) const
+  {
+    std::vector<creation_result_type> results(ids_.size());
+    // Lookups are lock-free, each item writes its own result only:
+    pool_.parallel_for(ids_.size(), [&](std::size_t i_) {
+        creation_result_type & result = results[i_];
+        // The lookup itself may throw (plugin loading, pending registrations):
+        try {
+          const factory_record_type * found = this->_lookup_(ids_[i_]);
+          if (found == nullptr) {
+            result.error = "Class ID '" + ids_[i_] + "' is not registered";
+            return;
+          }
+          result.object = found->fact(detail::batch_argument<Args>::pass(args_)...);
+          if (_creation_tracer_ != nullptr) _creation_tracer_->record(trace_operation::created, _label_, found->type_id);
+        } catch (std::exception & error_) {
+          result.error = error_.what();
+        } catch (...) {
+          result.error = "Unexpected exception while looking up or creating an object of class ID '" + ids_[i_] + "'";
+        }
+        return;
+      });
+    return results;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::destroy_batch(factory_batch_type & batch_) const
+  {
+    batch_.clear();
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::base_type *
+  factory_register<BaseType, Args...>::construct_in_place(const id_view_type & id_, void * storage_, std::size_t storage_size_, Args... args_) const
+  {
+    return this->construct_in_place(this->resolve(id_), storage_, storage_size_, std::forward<Args>(args_)...);
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::base_type *
+  factory_register<BaseType, Args...>::construct_in_place(const factory_handle_type & handle_, void * storage_, std::size_t storage_size_, Args... args_) const
+  {
+    static_assert(std::has_virtual_destructor<base_type>::value,
+                  "bxfactories::factory_register<>::construct_in_place: the base class has no virtual destructor!");
+    const factory_record_type & record = this->get_record(handle_);
+    if (record.construct == nullptr) {
+      std::ostringstream error_message;
+      error_message << "bxfactory::factory_register<>::construct_in_place(...): " << "Class ID '" << record.type_id << "' has no known layout !";
+      throw std::logic_error(error_message.str());
+    }
+    if (storage_ == nullptr
+        || storage_size_ < record.type_size
+        || reinterpret_cast<std::uintptr_t>(storage_) % record.type_alignment != 0) {
+      std::ostringstream error_message;
+      error_message << "bxfactory::factory_register<>::construct_in_place(...): " << "Storage at " << storage_
+                    << " (" << storage_size_ << " bytes) cannot host an object of class ID '" << record.type_id
+                    << "' (" << record.type_size << " bytes, aligned on " << record.type_alignment << ") !";
+      throw std::logic_error(error_message.str());
+    }
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+    const detail::factory_stats::clock_type::time_point start = detail::factory_stats::clock_type::now();
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+    base_type * object = record.construct(storage_, std::forward<Args>(args_)...);
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+    record.stats->on_created(detail::factory_stats::elapsed_ns(start));
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+    if (_creation_tracer_ != nullptr) _creation_tracer_->record(trace_operation::created, _label_, record.type_id);
+    return object;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::destroy_in_place(base_type * object_) const
+  {
+    if (object_ == nullptr) return;
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+    detail::factory_stats * stats = this->_find_stats_(*object_);
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+    object_->~base_type();
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+    if (stats != nullptr) stats->on_destroyed();
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::destroy(base_type * object_) const
+  {
+    if (object_ == nullptr) return;
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+    detail::factory_stats * stats = this->_find_stats_(*object_);
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+    delete object_;
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+    if (stats != nullptr) stats->on_destroyed();
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  bool factory_register<BaseType, Args...>::fetch_type_id(const std::type_info & tinfo_, std::string & id_) const
+  {
+    id_.clear();
+    // Classes are indexed by name, so this also works for type_info
+    // objects from distinct shared libraries:
+    const factory_record_type * record = _type_index_.find(tinfo_.name());
+    if (record != nullptr && !(*record->tinfo == tinfo_)) {
+      // Another class with the same name owns the entry:
+      std::lock_guard<std::mutex> lock(_mutex_);
+      typename type_index_type::const_iterator found = _types_.find(std::type_index(tinfo_));
+      record = found == _types_.end() ? nullptr : found->second.front();
+    }
+    if (record == nullptr) {
+      return false;
+    }
+    // If a class is registered under several IDs, the first one in ID order is used:
+    id_.assign(record->type_id.data(), record->type_id.size());
+    return true;
+  }
+
+  template <typename BaseType, typename... Args>
   template<class DerivedType>
-  bool factory_register<BaseType>::fetch_type_id(std::string & id_) const
+  bool factory_register<BaseType, Args...>::fetch_type_id(std::string & id_) const
   {
     id_.clear();
     if (!std::is_base_of<BaseType, DerivedType>::value) {
@@ -154,118 +971,344 @@ namespace bxfactories {
       error_message << "bxfactory::factory_register<>::fetch_type_id(...): " << "Class ID '" << id_ << "' is not registered !";
       throw std::logic_error(error_message.str());
     }
-    for (typename factory_map_type::const_iterator i = _registered_.begin();
-         i != _registered_.end();
-         ++i) {
-      if (&typeid(DerivedType) == i->second.tinfo) {
-        id_ = i->first;
-        return true;
-      }
-    }
-    return false;
+    return this->fetch_type_id(typeid(DerivedType), id_);
+  }
+
+  template <typename BaseType, typename... Args>
+  template <typename DerivedType>
+  typename factory_register<BaseType, Args...>::base_type *
+  factory_register<BaseType, Args...>::_construct_(void * storage_, Args &&... args_)
+  {
+    return ::new (storage_) DerivedType(std::forward<Args>(args_)...);
   }
 
-  template <typename BaseType>
+  template <typename BaseType, typename... Args>
   template <typename DerivedType>
-  void factory_register<BaseType>::register_factory(const std::string & id_,
+  void factory_register<BaseType, Args...>::register_factory(const std::string & id_,
                                                 const std::string & description_,
                                                 const std::string & category_)
   {
-    register_factory(id_,
-                     boost::factory<DerivedType*>(),
-                     typeid(DerivedType),
-                     description_,
-                     category_);
+    this->template register_factory<DerivedType>(factory_id(id_.data(), id_.size(), detail::hash_id(id_)), description_, category_);
     return;
   }
 
-  template <typename BaseType>
-  void factory_register<BaseType>::register_factory(const std::string & id_,
+  template <typename BaseType, typename... Args>
+  template <typename DerivedType>
+  void factory_register<BaseType, Args...>::register_factory(const factory_id & id_,
+                                                const std::string & description_,
+                                                const std::string & category_)
+  {
+    factory_record_type record;
+    record.type_id = id_.view();
+    record.type_hash = id_.hash();
+    record.fact = factory_type::template make<DerivedType>();
+    record.tinfo = &typeid(DerivedType);
+    record.description = description_;
+    record.category = category_;
+    record.type_size = sizeof(DerivedType);
+    record.type_alignment = alignof(DerivedType);
+    record.construct = &factory_register::template _construct_<DerivedType>;
+    this->_register_(std::move(record));
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  template <typename DerivedType>
+  void factory_register<BaseType, Args...>::register_prototype(const std::string & id_,
+                                                               const std::shared_ptr<const DerivedType> & prototype_,
+                                                               const std::string & description_,
+                                                               const std::string & category_)
+  {
+    static_assert(sizeof...(Args) == 0,
+                  "bxfactories::factory_register<>::register_prototype: prototypes need a register without creation arguments!");
+    static_assert(std::is_convertible<DerivedType *, base_type *>::value,
+                  "bxfactories::factory_register<>::register_prototype: the class does not inherit the base class!");
+    if (!prototype_) {
+      std::ostringstream error_message;
+      error_message << "bxfactory::factory_register<>::register_prototype(...): " << "Null prototype for class ID '" << id_ << "' !";
+      throw std::logic_error(error_message.str());
+    }
+    // The copy constructor of DerivedType would slice a prototype of a derived class:
+    if (!detail::has_clone<DerivedType, base_type>::value && typeid(*prototype_) != typeid(DerivedType)) {
+      std::ostringstream error_message;
+      error_message << "bxfactory::factory_register<>::register_prototype(...): " << "Prototype for class ID '" << id_ << "' is of a derived class, which cannot be copied without a clone() method !";
+      throw std::logic_error(error_message.str());
+    }
+    prototype_factory_type<DerivedType> prototype_factory;
+    prototype_factory.prototype = prototype_;
+    this->register_factory(id_, prototype_factory, typeid(*prototype_), description_, category_);
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  template <typename DerivedType>
+  typename factory_register<BaseType, Args...>::base_type *
+  factory_register<BaseType, Args...>::prototype_factory_type<DerivedType>::operator()() const
+  {
+    return _copy_(*prototype, detail::has_clone<DerivedType, base_type>());
+  }
+
+  template <typename BaseType, typename... Args>
+  template <typename DerivedType>
+  typename factory_register<BaseType, Args...>::base_type *
+  factory_register<BaseType, Args...>::prototype_factory_type<DerivedType>::_copy_(const DerivedType & prototype_, std::true_type)
+  {
+    return prototype_.clone();
+  }
+
+  template <typename BaseType, typename... Args>
+  template <typename DerivedType>
+  typename factory_register<BaseType, Args...>::base_type *
+  factory_register<BaseType, Args...>::prototype_factory_type<DerivedType>::_copy_(const DerivedType & prototype_, std::false_type)
+  {
+    static_assert(std::is_copy_constructible<DerivedType>::value,
+                  "bxfactories::factory_register<>::register_prototype: the class has neither a clone() method nor a copy constructor!");
+    return new DerivedType(prototype_);
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::register_factory(const std::string & id_,
                                                     const factory_type & factory_,
                                                     const std::type_info & tinfo_,
                                                     const std::string & description_,
                                                     const std::string & category_)
   {
-    if (_trace_) std::cerr << "[trace] bxfactory::factory_register<>::register_factory(...): " << "Registration of class with ID '" << id_ << "'" << std::endl;
-    typename factory_map_type::const_iterator found = _registered_.find(id_);
-    if (found != _registered_.end()) {
-      std::ostringstream error_message;
-      error_message << "bxfactory::factory_register<>::register_factory(...): " << "Class ID '" << id_ << "' is already registered !";
-      throw std::logic_error(error_message.str());
-    }
     factory_record_type record;
     record.type_id = id_;
-    record.description = description_;
-    record.category = category_;
+    record.type_hash = detail::hash_id(id_);
     record.fact = factory_;
     record.tinfo = &tinfo_;
-    _registered_[id_] = record;
+    record.description = description_;
+    record.category = category_;
+    this->_register_(std::move(record));
     return;
   }
 
-  template <typename BaseType>
-  void factory_register<BaseType>::unregister_factory(const std::string & id_)
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_register_(factory_record_type && record_)
   {
-    if (_trace_) std::cerr << "[trace] bxfactory::factory_register<>::unregistration(...): " << "Unregistration of class with ID '" << id_ << "'" << std::endl;
-    typename factory_map_type::const_iterator found = _registered_.find(id_);
+    std::lock_guard<std::mutex> lock(_mutex_);
+    this->_check_not_frozen_("register_factory");
+    if (this->_find_record_(record_.type_id, record_.type_hash) != nullptr) {
+      std::ostringstream error_message;
+      error_message << "bxfactory::factory_register<>::register_factory(...): " << "Class ID '" << record_.type_id << "' is already registered !";
+      throw std::logic_error(error_message.str());
+    }
+    typename factory_map_type::iterator entry = this->_insert_(std::move(record_), _registered_.end());
+    if (_tracer_) this->_trace_(trace_operation::registered, entry->first);
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::factory_map_type::iterator
+  factory_register<BaseType, Args...>::_insert_(factory_record_type && record_,
+                                                typename factory_map_type::iterator hint_)
+  {
+    typename factory_record_list_type::iterator inserted = _records_.insert(_records_.end(), std::move(record_));
+    factory_record_type & record = *inserted;
+    this->_intern_(record);
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+    this->_instrument_(record);
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+    record.handle = this->_acquire_slot_(&record);
+    // The dictionary and the indexes refer to the ID owned by the record:
+    typename factory_map_type::iterator entry = _registered_.emplace_hint(hint_, record.type_id, inserted);
+    this->_index_type_(record);
+    this->_index_category_(record);
+    // Publish the complete record for concurrent lookups:
+    _index_.insert(record.type_id, &record, record.type_hash);
+    _size_.fetch_add(1, std::memory_order_release);
+    _version_.fetch_add(1, std::memory_order_release);
+    return entry;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_erase_(typename factory_map_type::iterator found_)
+  {
+    typename factory_record_list_type::iterator record = found_->second;
+    _index_.erase(record->type_id, record->type_hash);
+    this->_unindex_type_(*record);
+    this->_unindex_category_(*record);
+    this->_release_slot_(record->handle);
+    _registered_.erase(found_);
+    // Concurrent lookups may still use the record:
+    _retired_.splice(_retired_.end(), _records_, record);
+    _size_.fetch_sub(1, std::memory_order_release);
+    _version_.fetch_add(1, std::memory_order_release);
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::unregister_factory(const std::string & id_)
+  {
+    std::lock_guard<std::mutex> lock(_mutex_);
+    this->_check_not_frozen_("unregister_factory");
+    typename factory_map_type::iterator found = _registered_.find(id_);
     if (found == _registered_.end()) {
       std::ostringstream error_message;
       error_message << "bxfactory::factory_register<>::unregister_factory(...): " << "Class ID '" << id_ << "' is not registered !";
       throw std::logic_error(error_message.str());
     }
-    _registered_.erase(id_);
+    this->_erase_(found);
+    if (_tracer_) this->_trace_(trace_operation::unregistered, id_);
     return;
   }
 
-  template <typename BaseType>
-  void factory_register<BaseType>::import(const factory_register & other_)
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_import_(std::vector<factory_record_type> && records_,
+                                                     import_policy_type policy_,
+                                                     const factory_register & other_,
+                                                     const char * where_)
   {
-    if (_trace_) std::cerr << "[trace] bxfactory::factory_register<>::import(...): " << "Importing registered factories from register '" << other_.get_label() << "'..." << std::endl;
-    for (typename factory_map_type::const_iterator i = other_._registered_.begin();
-         i != other_._registered_.end();
-         ++i) {
-      const factory_record_type & the_out_factory_record = i->second;
-      this->registration(i->first,
-                         the_out_factory_record.fact,
-                         *the_out_factory_record.tinfo,
-                         the_out_factory_record.description, 
-                         the_out_factory_record.category);
+    std::lock_guard<std::mutex> lock(_mutex_);
+    this->_check_not_frozen_(where_);
+    // Both the records and the dictionary are ordered by ID: conflicts are found by a merged walk.
+    if (policy_ == import_throw) {
+      std::ostringstream conflicts;
+      std::size_t nconflicts = 0;
+      typename factory_map_type::const_iterator pos = _registered_.begin();
+      for (const factory_record_type & record : records_) {
+        const id_view_type id(record.type_id);
+        while (pos != _registered_.end() && pos->first < id) ++pos;
+        if (pos != _registered_.end() && pos->first == id) {
+          conflicts << (nconflicts++ == 0 ? "'" : ", '") << id << "'";
+        }
+      }
+      if (nconflicts > 0) {
+        // Nothing is imported:
+        std::ostringstream error_message;
+        error_message << "bxfactory::factory_register<>::" << where_ << "(...): " << "Class IDs " << conflicts.str() << " from register '" << other_.get_label() << "' are already registered !";
+        throw std::logic_error(error_message.str());
+      }
+    }
+    _index_.reserve(records_.size());
+    typename factory_map_type::iterator pos = _registered_.begin();
+    for (factory_record_type & record : records_) {
+      const id_view_type id(record.type_id);
+      while (pos != _registered_.end() && pos->first < id) ++pos;
+      if (pos != _registered_.end() && pos->first == id) {
+        if (policy_ == import_skip) {
+          if (_tracer_) this->_trace_(trace_operation::kept, id);
+          continue;
+        }
+        if (_tracer_) this->_trace_(trace_operation::replaced, id);
+        typename factory_map_type::iterator replaced = pos++;
+        this->_erase_(replaced);
+      }
+      if (_tracer_) this->_trace_(trace_operation::imported, id);
+      // The record is inserted just before the next registered ID:
+      pos = std::next(this->_insert_(std::move(record), pos));
     }
     return;
   }
 
-  template <typename BaseType>
-  void factory_register<BaseType>::import_some(const factory_register & other_,
-                                               const std::set<std::string> & imported_factories_)
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::import(const factory_register & other_,
+                                                   import_policy_type policy_)
+  {
+    if (this == &other_) return;
+    if (_tracer_) this->_trace_(trace_operation::import, other_.get_label());
+    // Records are copied before registration, so that both registers are never locked together:
+    std::vector<factory_record_type> imported_records;
+    {
+      std::lock_guard<std::mutex> other_lock(other_._mutex_);
+      imported_records.reserve(other_._registered_.size());
+      for (typename factory_map_type::const_iterator i = other_._registered_.begin();
+           i != other_._registered_.end();
+           ++i) {
+        imported_records.push_back(*i->second);
+      }
+    }
+    this->_import_(std::move(imported_records), policy_, other_, "import");
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::import_some(const factory_register & other_,
+                                                        const std::set<std::string> & imported_factories_,
+                                                        import_policy_type policy_)
   {
     if (this == &other_) return; // Should we throw ?
-    if (_trace_) std::cerr << "[trace] bxfactory::factory_register<>::import_some(...): " << "Importing some registered factories from register '" << other_.get_label() << "'..." << std::endl;
-    for (typename factory_map_type::const_iterator i = other_._registered_.begin();
-         i != other_._registered_.end();
-         ++i) {
-      if (std::find(imported_factories_.begin(),
-                    imported_factories_.end(),
-                    i->first) != imported_factories_.end()) {
-        if (_trace_) std::cerr << "[trace] bxfactory::factory_register<>::import_some(...): " << "Importing registered factory '" << i->first << "' from register '" << other_.get_label() << "'..." << std::endl;
-        const factory_record_type & the_out_factory_record = i->second;
-        this->register_factory(i->first,
-                               the_out_factory_record.fact,
-                               *the_out_factory_record.tinfo,
-                               the_out_factory_record.description,
-                               the_out_factory_record.category);
+    if (_tracer_) this->_trace_(trace_operation::import, other_.get_label());
+    // Selected records are copied before registration, so that both registers are never locked together:
+    std::vector<factory_record_type> imported_records;
+    imported_records.reserve(imported_factories_.size());
+    {
+      std::lock_guard<std::mutex> other_lock(other_._mutex_);
+      // Both the selected IDs and the dictionary are ordered: they are walked together.
+      typename factory_map_type::const_iterator i = other_._registered_.begin();
+      std::set<std::string>::const_iterator j = imported_factories_.begin();
+      while (i != other_._registered_.end() && j != imported_factories_.end()) {
+        const int order = i->first.compare(*j);
+        if (order < 0) {
+          ++i;
+        } else if (order > 0) {
+          // Unknown IDs are ignored:
+          ++j;
+        } else {
+          imported_records.push_back(*i->second);
+          ++i;
+          ++j;
+        }
+      }
+    }
+    this->_import_(std::move(imported_records), policy_, other_, "import_some");
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::import_prefix(const factory_register & other_,
+                                                          const std::string & prefix_,
+                                                          import_policy_type policy_)
+  {
+    if (this == &other_) return;
+    if (_tracer_) this->_trace_(trace_operation::import, other_.get_label());
+    std::vector<factory_record_type> imported_records;
+    {
+      std::lock_guard<std::mutex> other_lock(other_._mutex_);
+      // IDs with a given prefix are contiguous in the dictionary:
+      for (typename factory_map_type::const_iterator i = other_._registered_.lower_bound(prefix_);
+           i != other_._registered_.end() && i->first.starts_with(prefix_);
+           ++i) {
+        imported_records.push_back(*i->second);
       }
     }
+    this->_import_(std::move(imported_records), policy_, other_, "import_prefix");
     return;
   }
 
-  template <typename BaseType>
-  void factory_register<BaseType>::print(std::ostream & out_,
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::import_category(const factory_register & other_,
+                                                            const std::string & category_,
+                                                            import_policy_type policy_)
+  {
+    if (this == &other_) return;
+    if (_tracer_) this->_trace_(trace_operation::import, other_.get_label());
+    std::vector<factory_record_type> imported_records;
+    {
+      std::lock_guard<std::mutex> other_lock(other_._mutex_);
+      // Records of a category are indexed in ID order:
+      typename category_index_type::const_iterator found = other_._categories_.find(category_);
+      if (found != other_._categories_.end()) {
+        imported_records.reserve(found->second.size());
+        for (const factory_record_type * record : found->second) {
+          imported_records.push_back(*record);
+        }
+      }
+    }
+    this->_import_(std::move(imported_records), policy_, other_, "import_category");
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::print(std::ostream & out_,
                                          const std::string & indent_,
                                          const std::string & title_) const
   {
     static const std::string item_tag = "|-- ";
     static const std::string last_item_tag = "`-- ";
     static const std::string last_item_skip_tag = "    ";
+    std::lock_guard<std::mutex> lock(_mutex_);
     if (!title_.empty()) {
       out_ << indent_ << title_ << std::endl;
     }
@@ -289,18 +1332,126 @@ namespace bxfactories {
       } else {
         out_ << item_tag;
       }
-      out_ << "ID: \"" << i->first << "\" @ " << &i->second.fact;
-      if (!i->second.description.empty()) {
-        out_ << ": " << i->second.description;
+      out_ << "ID: \"" << i->first << "\" @ " << &i->second->fact;
+      if (!i->second->description.empty()) {
+        out_ << ": " << i->second->description;
       }
-      if (!i->second.category.empty()) {
-        out_ << " (" << i->second.category << ')';
+      if (!i->second->category.empty()) {
+        out_ << " (" << i->second->category << ')';
       }
       out_ << std::endl;
     }
     return;
   }
 
+  template <typename BaseType, typename... Args>
+  bool factory_register<BaseType, Args...>::is_instrumented()
+  {
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::snapshot_stats(std::vector<factory_stats_snapshot> & snapshots_) const
+  {
+    snapshots_.clear();
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+    std::lock_guard<std::mutex> lock(_mutex_);
+    snapshots_.reserve(_registered_.size());
+    for (typename factory_map_type::const_iterator i = _registered_.begin();
+         i != _registered_.end();
+         ++i) {
+      snapshots_.push_back(factory_stats_snapshot());
+      factory_stats_snapshot & snapshot = snapshots_.back();
+      snapshot.type_id.assign(i->second->type_id.data(), i->second->type_id.size());
+      if (i->second->stats) i->second->stats->snapshot(snapshot);
+    }
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::print_stats(std::ostream & out_,
+                                                        const std::string & indent_,
+                                                        const std::string & title_) const
+  {
+    static const std::string item_tag = "|-- ";
+    static const std::string last_item_tag = "`-- ";
+    static const std::string last_item_skip_tag = "    ";
+    std::vector<factory_stats_snapshot> snapshots;
+    this->snapshot_stats(snapshots);
+    if (!title_.empty()) {
+      out_ << indent_ << title_ << std::endl;
+    }
+
+    out_ << indent_ << item_tag
+         << "Label   : '"
+         << _label_ << "'" << std::endl;
+
+    if (!is_instrumented()) {
+      out_ << indent_ << last_item_tag
+           << "Instrumentation : disabled" << std::endl;
+      return;
+    }
+
+    out_ << indent_ << last_item_tag
+         << "Factories : " << snapshots.size() << std::endl;
+
+    for (std::size_t i = 0; i < snapshots.size(); i++) {
+      const factory_stats_snapshot & snapshot = snapshots[i];
+      out_ << indent_ << last_item_skip_tag
+           << (i + 1 == snapshots.size() ? last_item_tag : item_tag)
+           << "ID: \"" << snapshot.type_id << "\""
+           << " created=" << snapshot.created
+           << " destroyed=" << snapshot.destroyed
+           << " mean=" << snapshot.mean_latency_ns() << " ns" << std::endl;
+    }
+    return;
+  }
+
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+
+  template <typename BaseType, typename... Args>
+  typename factory_register<BaseType, Args...>::base_type *
+  factory_register<BaseType, Args...>::instrumented_factory_type::operator()(Args... args_) const
+  {
+    const detail::factory_stats::clock_type::time_point start = detail::factory_stats::clock_type::now();
+    base_type * object = record->creator(std::forward<Args>(args_)...);
+    record->stats->on_created(detail::factory_stats::elapsed_ns(start));
+    return object;
+  }
+
+  template <typename BaseType, typename... Args>
+  void factory_register<BaseType, Args...>::_instrument_(factory_record_type & record_)
+  {
+    // Records copied from another register already wrap their factory:
+    if (!record_.stats) {
+      record_.creator = record_.fact;
+    }
+    record_.stats = std::make_shared<detail::factory_stats>();
+    if (record_.creator) {
+      instrumented_factory_type instrumented;
+      instrumented.record = &record_;
+      record_.fact = instrumented;
+    }
+    return;
+  }
+
+  template <typename BaseType, typename... Args>
+  detail::factory_stats *
+  factory_register<BaseType, Args...>::_find_stats_(const base_type & object_) const
+  {
+    const std::type_info & tinfo = typeid(object_);
+    const factory_record_type * record = _type_index_.find(tinfo.name());
+    if (record == nullptr || !(*record->tinfo == tinfo)) return nullptr;
+    return record->stats.get();
+  }
+
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+
 } // namespace bxfactories
 
 #endif // BXFACTORIES_FACTORY_INL_HPP
@@ -1,7 +1,7 @@
 /// \file bxfactories/factory.hpp
 /* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
  * Creation date : 2020-03-18
- * Last modified : 2020-03-18
+ * Last modified : 2026-10-17
  *
  */
 
@@ -9,18 +9,40 @@
 #define BXFACTORIES_FACTORY_HPP
 
 // Standard Library:
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 #include <string>
 #include <map>
+#include <vector>
 #include <set>
 #include <iostream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <type_traits>
-
-// Third Party:
-// - Boost:
-#include <boost/function.hpp>
-#include <boost/functional/factory.hpp>
+#include <typeindex>
+#include <unordered_map>
+
+// This project:
+#include <bxfactories/factory_function.hpp>
+#include <bxfactories/factory_batch.hpp>
+#include <bxfactories/factory_stats.hpp>
+#include <bxfactories/factory_trace.hpp>
+#include <bxfactories/auto_registration.hpp>
+#include <bxfactories/plugin_manifest.hpp>
+#include <bxfactories/record_view.hpp>
+#include <bxfactories/id_index.hpp>
+#include <bxfactories/factory_id.hpp>
+#include <bxfactories/chunked_array.hpp>
+#include <bxfactories/string_arena.hpp>
+#include <bxfactories/perfect_hash_index.hpp>
+#include <bxfactories/thread_pool.hpp>
 
 namespace bxfactories {
   
@@ -31,7 +53,8 @@ namespace bxfactories {
   public:
     
     enum flag_type {
-      init_trace = 0x1
+      init_trace           = 0x1, ///< Trace the operations on the register to std::cerr
+      init_trace_creations = 0x2  ///< Also trace the creation of objects (with init_trace)
     };
 
     /// Default constructor
@@ -43,27 +66,170 @@ namespace bxfactories {
   };
 
 
-  /// \brief Template factory registration class
-  template <class BaseType>
+  namespace detail {
+
+    /// Check if a class has a const clone() method returning a pointer convertible to ResultType*
+    template <class Type, class ResultType, class = void>
+    struct has_clone
+      : std::false_type
+    {};
+
+    template <class Type, class ResultType>
+    struct has_clone<Type, ResultType,
+                     typename std::enable_if<std::is_convertible<decltype(std::declval<const Type &>().clone()), ResultType *>::value>::type>
+      : std::true_type
+    {};
+
+  } // end of namespace detail
+
+  /*! \brief Template factory registration class
+   *
+   *  A factory register can be shared by several threads: lookups and
+   *  object creation (has(), find(), get(), try_get(), get_record(),
+   *  resolve(), create(), try_create(), fetch_type_id()...) never lock
+   *  and may run concurrently with the registration or unregistration
+   *  of factories, which are serialized by an internal mutex. The records of unregistered factories are
+   *  retired rather than destroyed, so that a concurrent lookup never
+   *  sees a dangling record. Retired records, the index tables superseded
+   *  when the index grows and the interned strings of retired records
+   *  accumulate under register/unregister churn (plugin load/unload
+   *  cycles...): they are released by compact() or with the register.
+   *  Copy, assignment, set_label(), reset() and compact() must not run
+   *  concurrently with any other operation on the same register.
+   *
+   *  Once all factories are registered, typically after the static
+   *  initialization and the loading of plugins, a register can be frozen.
+   *  Its records are then compiled into an immutable minimal perfect hash
+   *  table, and any further registration or unregistration is rejected.
+   *
+   *  The optional Args parameters declare the creation signature: the
+   *  arguments passed to a factory are forwarded to the constructor of
+   *  the created object, which can so be fully built in place rather than
+   *  default constructed then configured.
+   *
+   *  If the BXFACTORIES_WITH_INSTRUMENTATION macro is defined, the register
+   *  collects creation statistics for each factory: number of created and
+   *  destroyed objects, histogram of the construction times. All creations
+   *  are counted, but only the objects destroyed through the register
+   *  (destroy(), destroy_in_place(), batches, pools) are counted as
+   *  destroyed, hence the number of live objects is not tracked. The
+   *  macro must be defined consistently in all translation units.
+   *  Otherwise, no statistics are collected and creation has no overhead.
+   *
+   *  A system register can be associated to a plugin manifest: a lookup
+   *  of an unknown ID then loads the library which provides it, if any,
+   *  and is retried, unless the register is frozen.
+   *
+   *  Operations on the register (registration, unregistration, clearing,
+   *  import, plugin loading and optionally creation) can be traced: each
+   *  one records a binary event in a lock-free trace buffer, formatted
+   *  later by a trace writer or any other consumer. Without a trace
+   *  buffer, tracing costs one test per operation.
+   */
+  template <class BaseType, class... Args>
   class factory_register
     : public base_factory_register
   {
   public:
 
-    typedef BaseType                       base_type;
-    typedef boost::function<base_type*() > factory_type;
+    typedef BaseType                             base_type;
+    typedef factory_function<base_type, Args...> factory_type;
+
+    /*! \brief Pre-resolved reference to a registered factory
+     *
+     *  A handle is a small trivially copyable token obtained once from
+     *  a registration ID with resolve(). Creating objects through it
+     *  involves no string handling nor hashing. A handle remains valid
+     *  whatever other factories are registered or unregistered, and
+     *  becomes invalid, in a detectable way, as soon as the factory it
+     *  refers to is unregistered or the register is cleared.
+     */
+    struct factory_handle_type {
+      std::uint32_t slot = 0;       ///< Index of the slot in the register
+      std::uint32_t generation = 0; ///< Generation of the slot at resolution time (0: null handle)
+    };
+
+    /// \brief Function constructing an object of a registered class in supplied storage
+    typedef base_type * (*factory_placement_type)(void * storage_, Args &&... args_);
 
     /// \brief Record for a factory
+    ///
+    /// The storage requirements and the in-place constructor of the
+    /// registered class are only known for classes registered with
+    /// register_factory<DerivedType>().
+    ///
+    /// The texts are not stored in records: the ID, the description and
+    /// the category are views on strings interned by the register, which
+    /// are never released before the register is destroyed or assigned.
+    /// IDs are packed together, apart from the descriptions and the
+    /// categories, and each distinct category is stored once. Records are
+    /// not split into hot and cold parts: a record, with its views, is one
+    /// node of the list of records.
     struct factory_record_type {
-      std::string  type_id;
       factory_type fact;
+      factory_placement_type construct = nullptr; ///< In-place constructor of the registered class (null if unknown)
+      std::size_t  type_size = 0;      ///< Size of the registered class (0 if unknown)
+      std::size_t  type_alignment = 0; ///< Alignment of the registered class (0 if unknown)
       const std::type_info * tinfo = nullptr;
-      std::string  description;
-      std::string  category;
+      factory_handle_type handle; ///< Handle associated to this record in its register
+      std::uint64_t type_hash = 0; ///< Hash of the registration ID (see detail::hash_id())
+      id_view_type type_id;       ///< Registration ID
+      id_view_type description;   ///< Description of the factory
+      id_view_type category;      ///< Category of the factory
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+      factory_type creator; ///< Factory wrapped by the instrumented factory
+      std::shared_ptr<detail::factory_stats> stats; ///< Creation statistics
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
     };
     
-    /// \brief Dictionary of object factories
-    typedef std::map<std::string, factory_record_type> factory_map_type;
+    /// \brief List of factory records (with stable addresses)
+    typedef std::list<factory_record_type> factory_record_list_type;
+
+    /// \brief Dictionary of object factories, ordered by registration ID
+    typedef std::map<boost::string_view, typename factory_record_list_type::iterator> factory_map_type;
+
+    /// \brief Hashed index of object factories
+    typedef detail::id_index<factory_record_type> factory_index_type;
+
+    /// \brief Reverse index of object factories, by registered type
+    ///
+    /// Records of a given type are ordered by registration ID.
+    typedef std::unordered_map<std::type_index, std::vector<const factory_record_type *> > type_index_type;
+
+    /// \brief Reverse index of object factories, by category
+    ///
+    /// Records of a given category are ordered by registration ID.
+    /// Keys are the categories interned by the register.
+    typedef std::map<boost::string_view, std::vector<const factory_record_type *> > category_index_type;
+
+    /// \brief Records of the registered factories, in ID order
+    typedef record_view<factory_record_type, typename factory_map_type::const_iterator> records_view_type;
+
+    /// \brief Records of the factories whose ID starts with a given prefix, in ID order
+    typedef records_view_type prefix_view_type;
+
+    /// \brief Records of the factories of a given category, in ID order
+    typedef record_view<factory_record_type, typename std::vector<const factory_record_type *>::const_iterator> category_view_type;
+
+    /// \brief Records of registered factories copied as pointers, in ID order
+    typedef record_snapshot<factory_record_type> record_snapshot_type;
+
+    /// \brief Immutable index of object factories, used once the register is frozen
+    typedef detail::perfect_hash_index<factory_record_type> factory_frozen_index_type;
+
+    /// \brief Objects of one registered class created in contiguous storage
+    typedef factory_batch<base_type> factory_batch_type;
+
+    /// \brief Outcome of the creation of one object of a set
+    struct creation_result_type {
+      base_type * object = nullptr; ///< Created object (owned by the caller), or null on failure
+      std::string error;            ///< Reason of the failure, empty on success
+    };
+
+    /// \brief Hashed reverse index of object factories, by registered type name
+    ///
+    /// Only the first record of each type (in ID order) is indexed.
+    typedef detail::id_index<const factory_record_type> factory_type_index_type;
 
     /// Constructor
     factory_register() = default;
@@ -71,20 +237,87 @@ namespace bxfactories {
     /// Constructor
     factory_register(const std::string & label_, const unsigned int flags_ = 0x0);
 
+    /// Copy constructor
+    factory_register(const factory_register & other_);
+
     /// Destructor
     virtual ~factory_register();
 
+    /// Copy assignment
+    factory_register & operator=(const factory_register & other_);
+
     //! Get the label associated to the factory
     const std::string & get_label() const;
 
     //! Set the label associated to the factory
     void set_label(const std::string & label_);
 
+    /// Return the trace buffer which records the operations on the register (may be null)
+    const std::shared_ptr<trace_buffer> & get_tracer() const;
+
+    /// Set the trace buffer which records the operations on the register (null: no tracing)
+    ///
+    /// If trace_creations_ is set, objects created through the register
+    /// (create(), try_create(), create_batch(), create_set(), construct_in_place())
+    /// are traced too; calls of a factory returned by get() are not.
+    /// Must not run concurrently with any other operation on the register.
+    void set_tracer(const std::shared_ptr<trace_buffer> & tracer_, bool trace_creations_ = false);
+
+    /// Return the manifest of the plugin libraries loaded on demand (may be null)
+    const std::shared_ptr<plugin_manifest> & get_plugin_manifest() const;
+
+    /// Set the manifest of the plugin libraries loaded on demand (null: no plugin loading)
+    ///
+    /// Plugin libraries auto-register their classes in the system register
+    /// of the base class: other registers reject a manifest. Lookups on a
+    /// frozen register do not load libraries anymore. The manifest is not
+    /// copied with the register. Must not run concurrently with any other
+    /// operation on the register.
+    void set_plugin_manifest(const std::shared_ptr<plugin_manifest> & manifest_);
+
     /// Copy factory IDs into supplied container
     void list_of_factory_ids(std::set<std::string> & ids_, bool clear_ = false) const;
 
+    /// Return the number of registered factories
+    std::size_t size() const;
+
+    /// Return the version of the register, incremented by each (un)registration
+    ///
+    /// Results computed from the registered factories can be cached with the
+    /// version, and recomputed only when it has changed.
+    std::uint64_t get_version() const;
+
+    /// Return the records of all registered factories
+    ///
+    /// Only the pointers to the records are copied, and the register is
+    /// not locked while they are walked: it may be used, and modified,
+    /// from the walking thread.
+    record_snapshot_type records() const;
+
+    /// Return the records of the factories whose ID starts with a given prefix
+    record_snapshot_type records_with_prefix(const std::string & prefix_) const;
+
+    /// Return the records of the factories of a given category
+    record_snapshot_type records_in_category(const std::string & category_) const;
+
+    /// Return a view of the records of all registered factories, which locks the register
+    ///
+    /// For expert use: nothing is copied, but the register is locked for
+    /// the lifetime of the view, and the owning thread must not call any
+    /// locking member of the register (see record_view).
+    records_view_type lock_records() const;
+
+    /// Return a view of the records of the factories whose ID starts with a given prefix, which locks the register
+    prefix_view_type lock_records_with_prefix(const std::string & prefix_) const;
+
+    /// Return a view of the records of the factories of a given category, which locks the register
+    category_view_type lock_records_in_category(const std::string & category_) const;
+
+    /// Copy the categories of the registered factories into supplied container
+    void list_of_categories(std::set<std::string> & categories_, bool clear_ = false) const;
+
     /// Return true if a factory with given ID is registered
-    bool has(const std::string & id_) const;
+    bool has(const id_view_type & id_) const;
 
     /// Return true if a factory with given ID is registered with given group
     bool is_group(const std::string & id_) const;
@@ -92,17 +325,143 @@ namespace bxfactories {
     /// Clear all registered factories
     void clear();
 
-    /// Reset the factory register
+    /// Reset the factory register, which is unfrozen
     void reset();
 
+    /// Release the memory kept for concurrent lookups: retired records, superseded index tables, unused strings
+    ///
+    /// The records of the registered factories stay in place but their
+    /// strings are moved: the views on the ID, description and category of
+    /// a record, as well as locked record views (lock_records()...), are invalidated;
+    /// pointers to records and handles remain valid. Must not run
+    /// concurrently with any other operation on the register, nor while a
+    /// factory pool built on the register is alive.
+    void compact();
+
+    /// Freeze the register: compile the lookup structures and reject further modifications
+    ///
+    /// Return true if lookups use the perfect hash table. The table cannot
+    /// be built if two IDs have the same 64-bit hash, or if its construction
+    /// gives up after max_attempts_ tries to place a bucket of IDs (0:
+    /// automatic). The register is then frozen all the same, and lookups
+    /// keep on using the hashed index, which is never modified anymore.
+    bool freeze(std::size_t max_attempts_ = 0);
+
+    /// Return true if the register is frozen
+    bool is_frozen() const;
+
+    /// Return true if the register is frozen and its lookups use the perfect hash table
+    bool is_perfectly_indexed() const;
+
     /// Return a mutable reference to a factory given its registration ID
-    factory_type & grab(const std::string & id_);
+    factory_type & grab(const id_view_type & id_);
 
     /// Return a const reference to a factory given its registration ID
-    const factory_type & get(const std::string & id_) const;
+    const factory_type & get(const id_view_type & id_) const;
 
     /// Return a const reference to a factory record given its registration ID
-    const factory_record_type & get_record(const std::string & id_) const;
+    const factory_record_type & get_record(const id_view_type & id_) const;
+
+    /// Return the factory record registered under a given ID, or null if it is not registered
+    ///
+    /// Unlike get_record(), a miss neither allocates nor throws.
+    const factory_record_type * find(const id_view_type & id_) const;
+
+    /// Return the factory registered under a given ID, or null if it is not registered
+    const factory_type * try_get(const id_view_type & id_) const;
+
+    /// Create a new object from the factory registered under a given ID, or return null if it is not registered
+    base_type * try_create(const id_view_type & id_, Args... args_) const;
+
+    /// Return the handle associated to a factory given its registration ID
+    factory_handle_type resolve(const id_view_type & id_) const;
+
+    /// Return true if a factory with given ID is registered (the ID is not hashed)
+    bool has(const factory_id & id_) const;
+
+    /// Return a const reference to a factory given its registration ID (the ID is not hashed)
+    const factory_type & get(const factory_id & id_) const;
+
+    /// Return a const reference to a factory record given its registration ID (the ID is not hashed)
+    const factory_record_type & get_record(const factory_id & id_) const;
+
+    /// Return the factory record registered under a given ID, or null (the ID is not hashed)
+    const factory_record_type * find(const factory_id & id_) const;
+
+    /// Return the factory registered under a given ID, or null (the ID is not hashed)
+    const factory_type * try_get(const factory_id & id_) const;
+
+    /// Create a new object from the factory registered under a given ID, or return null (the ID is not hashed)
+    base_type * try_create(const factory_id & id_, Args... args_) const;
+
+    /// Return the handle associated to a factory given its registration ID (the ID is not hashed)
+    factory_handle_type resolve(const factory_id & id_) const;
+
+    /// Return true if a handle refers to a factory which is still registered
+    bool has(const factory_handle_type & handle_) const;
+
+    /// Return a const reference to a factory given its handle
+    const factory_type & get(const factory_handle_type & handle_) const;
+
+    /// Return a const reference to a factory record given its handle
+    const factory_record_type & get_record(const factory_handle_type & handle_) const;
+
+    /// Return the factory record referenced by a handle, or null if the handle is not valid
+    const factory_record_type * find(const factory_handle_type & handle_) const;
+
+    /// Return the factory referenced by a handle, or null if the handle is not valid
+    const factory_type * try_get(const factory_handle_type & handle_) const;
+
+    /// Create a new object from the factory referenced by a handle, forwarding the arguments to its constructor
+    base_type * create(const factory_handle_type & handle_, Args... args_) const;
+
+    /// Create a new object from the factory referenced by a handle, or return null if the handle is not valid
+    base_type * try_create(const factory_handle_type & handle_, Args... args_) const;
+
+    /// Create a batch of objects of the class registered under a given ID, in contiguous storage
+    ///
+    /// The ID is resolved once and the objects are constructed one after the
+    /// other in a single arena. Each constructor is passed the arguments:
+    /// lvalue references as is, other arguments by copy.
+    factory_batch_type create_batch(const id_view_type & id_, std::size_t count_, Args... args_) const;
+
+    /// Create a batch of objects of the class referenced by a handle, in contiguous storage
+    factory_batch_type create_batch(const factory_handle_type & handle_, std::size_t count_, Args... args_) const;
+
+    /// Create one object per registration ID, concurrently on a thread pool
+    ///
+    /// The results are returned in the order of the IDs. A failure (unregistered
+    /// ID, failed lookup, throwing constructor) is reported in the result of its item and does
+    /// not prevent the creation of the other objects. Each constructor is passed
+    /// the arguments: lvalue references as is, other arguments by copy; objects
+    /// referring to shared arguments must not modify them. The register must not
+    /// be modified during the creation.
+    std::vector<creation_result_type> create_set(const std::vector<std::string> & ids_,
+                                                 thread_pool & pool_,
+                                                 Args... args_) const;
+
+    /// Destroy the objects of a batch and release their storage
+    void destroy_batch(factory_batch_type & batch_) const;
+
+    /// Construct an object of the class registered under a given ID in caller-supplied storage
+    ///
+    /// The storage must be at least get_record(id_).type_size bytes long and
+    /// aligned on get_record(id_).type_alignment. Only classes registered with
+    /// register_factory<DerivedType>() have a known layout. The object must be
+    /// destroyed with destroy_in_place(), the storage remains owned by the caller.
+    base_type * construct_in_place(const id_view_type & id_, void * storage_, std::size_t storage_size_, Args... args_) const;
+
+    /// Construct an object of the class referenced by a handle in caller-supplied storage
+    base_type * construct_in_place(const factory_handle_type & handle_, void * storage_, std::size_t storage_size_, Args... args_) const;
+
+    /// Destroy an object constructed with construct_in_place(), without releasing its storage
+    void destroy_in_place(base_type * object_) const;
+
+    /// Destroy an object created by a factory of the register
+    ///
+    /// Equivalent to the delete operator, the destruction is also
+    /// accounted for by the creation statistics, if any.
+    void destroy(base_type * object_) const;
 
     /// Register the supplied factory under the given ID
     void register_factory(const std::string & id_,
@@ -117,6 +476,29 @@ namespace bxfactories {
                           const std::string & description_ = "",
                           const std::string & category_ = "");
 
+    /// Register the supplied factory under the given ID, with its precomputed hash
+    template<class DerivedType>
+    void register_factory(const factory_id & id_,
+                          const std::string & description_ = "",
+                          const std::string & category_ = "");
+
+    /// Register a prototype under the given ID: objects are created as copies of the prototype
+    ///
+    /// The prototype is constructed once, then shared read-only by the
+    /// factory (and by the copies of the register): objects are created by
+    /// its clone() method if it has one returning a pointer convertible to
+    /// base_type*, by the copy constructor of DerivedType otherwise. Only
+    /// registers without creation arguments accept prototypes. The registered
+    /// type is the dynamic type of the prototype, whose layout is unknown:
+    /// clone() must create objects of that type. Without clone(), a prototype
+    /// of a class derived from DerivedType, which would be sliced by the
+    /// copy, is rejected.
+    template<class DerivedType>
+    void register_prototype(const std::string & id_,
+                            const std::shared_ptr<const DerivedType> & prototype_,
+                            const std::string & description_ = "",
+                            const std::string & category_ = "");
+
     /// Fetch the registration type ID associated to a given class
     template<class DerivedType>
     bool fetch_type_id(std::string & id_) const;
@@ -127,24 +509,195 @@ namespace bxfactories {
     /// Remove of the factory stored under supplied registration type ID
     void unregister_factory(const std::string & id_);
 
+    /// \brief Policy applied to the imported factories whose ID is already registered
+    enum import_policy_type {
+      import_throw = 0,    ///< Throw and import nothing
+      import_skip = 1,     ///< Keep the registered factory
+      import_overwrite = 2 ///< Replace the registered factory
+    };
+
     /// Import all registered factories from another factory register
-    void import(const factory_register & factory_register_);
+    void import(const factory_register & factory_register_,
+                import_policy_type policy_ = import_throw);
 
     /// Import only registered factories addressed by their registration names
     /// from another factory register
     void import_some(const factory_register & factory_register_,
-                     const std::set<std::string> & imported_factories_);
+                     const std::set<std::string> & imported_factories_,
+                     import_policy_type policy_ = import_throw);
+
+    /// Import the registered factories whose ID starts with a given prefix
+    /// from another factory register
+    void import_prefix(const factory_register & factory_register_,
+                       const std::string & prefix_,
+                       import_policy_type policy_ = import_throw);
+
+    /// Import the registered factories of a given category from another factory register
+    void import_category(const factory_register & factory_register_,
+                         const std::string & category_,
+                         import_policy_type policy_ = import_throw);
 
     /// Smart print for debugging/logging purpose
     void print(std::ostream & out_,
                const std::string & indent_ = "",
                const std::string & title_ = "") const;
 
+    /// Return true if the register collects creation statistics
+    static bool is_instrumented();
+
+    /// Copy the creation statistics of all factories, in ID order, into supplied container
+    ///
+    /// The container is left empty if the register is not instrumented.
+    void snapshot_stats(std::vector<factory_stats_snapshot> & snapshots_) const;
+
+    /// Print the creation statistics of all factories
+    void print_stats(std::ostream & out_,
+                     const std::string & indent_ = "",
+                     const std::string & title_ = "") const;
+
+  private:
+
+    /// Return the record stored under a registration ID, or null if it is not registered
+    factory_record_type * _find_record_(const id_view_type & id_) const;
+
+    /// Return the record stored under a registration ID with precomputed hash, or null if it is not registered
+    factory_record_type * _find_record_(const id_view_type & id_, std::uint64_t hash_) const;
+
+    /// Return the record stored under a registration ID, loading its plugin library if needed, or null if it is not registered
+    factory_record_type * _lookup_(const id_view_type & id_) const;
+
+    /// Return the record stored under a registration ID with precomputed hash, loading its plugin library if needed, or null
+    factory_record_type * _lookup_(const id_view_type & id_, std::uint64_t hash_) const;
+
+    /// Return the record stored under a registration ID with precomputed hash, or throw
+    factory_record_type & _get_record_(const id_view_type & id_, std::uint64_t hash_, const char * where_) const;
+
+    /// Load the plugin library providing a registration ID, then return its record, or null
+    factory_record_type * _load_plugin_(const id_view_type & id_, std::uint64_t hash_) const;
+
+    /// Return the record referenced by a handle, or null if the handle is not valid
+    const factory_record_type * _find_record_(const factory_handle_type & handle_) const;
+
+    /// Intern the ID, the description and the category of a record which is not published yet
+    void _intern_(factory_record_type & record_);
+
+    /// Copy the factories registered in another register, preserving handles (both registers must be locked)
+    void _copy_from_(const factory_register & other_);
+
+    /// Remove all factories (the register must be locked)
+    void _clear_();
+
+    /// Record an operation on a factory in the trace buffer (which must be set)
+    void _trace_(trace_operation operation_, const id_view_type & id_) const;
+
+    /// Register a new record
+    void _register_(factory_record_type && record_);
+
+    /// Insert a record whose ID is not registered, near a hint in the dictionary (the register must be locked)
+    typename factory_map_type::iterator _insert_(factory_record_type && record_,
+                                                 typename factory_map_type::iterator hint_);
+
+    /// Remove a registered record (the register must be locked)
+    void _erase_(typename factory_map_type::iterator found_);
+
+    /// Register imported records, ordered by ID, with a given conflict policy
+    void _import_(std::vector<factory_record_type> && records_,
+                  import_policy_type policy_,
+                  const factory_register & other_,
+                  const char * where_);
+
+    /// Construct an object of a given class in supplied storage
+    template<class DerivedType>
+    static base_type * _construct_(void * storage_, Args &&... args_);
+
+    /// \brief Factory creating copies of a shared prototype
+    template<class DerivedType>
+    struct prototype_factory_type {
+      std::shared_ptr<const DerivedType> prototype; ///< Prototype (read-only)
+      base_type * operator()() const;
+      static base_type * _copy_(const DerivedType & prototype_, std::true_type /* clone */);
+      static base_type * _copy_(const DerivedType & prototype_, std::false_type /* clone */);
+    };
+
+    /// Build and publish the immutable index (the register must be locked)
+    bool _freeze_(std::size_t max_attempts_ = 0);
+
+    /// Throw if the register is frozen
+    void _check_not_frozen_(const char * where_) const;
+
+    /// Add a record to the reverse indexes by type (the register must be locked)
+    void _index_type_(const factory_record_type & record_);
+
+    /// Remove a record from the reverse indexes by type (the register must be locked)
+    void _unindex_type_(const factory_record_type & record_);
+
+    /// Add a record to the index by category (the register must be locked)
+    void _index_category_(const factory_record_type & record_);
+
+    /// Remove a record from the index by category (the register must be locked)
+    void _unindex_category_(const factory_record_type & record_);
+
+    /// Update the hashed reverse index entry of a class (the register must be locked)
+    void _reindex_type_(const std::type_info & tinfo_);
+
+    /// Allocate a new handle slot for a record (the register must be locked)
+    factory_handle_type _acquire_slot_(factory_record_type * record_);
+
+    /// Release the handle slot of a record, invalidating all handles to it (the register must be locked)
+    void _release_slot_(const factory_handle_type & handle_);
+
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+
+    /// \brief Factory measuring the creations of the factory it wraps
+    struct instrumented_factory_type {
+      const factory_record_type * record; ///< Record with the wrapped factory and the statistics
+      base_type * operator()(Args... args_) const;
+    };
+
+    /// Give a record fresh statistics and wrap its factory with an instrumented factory
+    void _instrument_(factory_record_type & record_);
+
+    /// Return the statistics of the record of the dynamic type of an object, or null if the type is not registered
+    detail::factory_stats * _find_stats_(const base_type & object_) const;
+
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+
+    /// \brief Slot referenced by handles
+    struct handle_slot_type {
+      std::atomic<std::uint32_t>         generation{1};      ///< Current generation of the slot
+      std::atomic<factory_record_type *> record{nullptr};    ///< Record owning the slot (null if the slot is free)
+    };
+
+    typedef detail::chunked_array<handle_slot_type> handle_slot_array_type;
+
   private:
     
-    bool             _trace_ = false; ///< Trace log flag
-    std::string      _label_;         ///< Label of the factory
-    factory_map_type _registered_;    ///< Dictionary of registered factories
+    std::shared_ptr<trace_buffer> _tracer_; ///< Trace buffer (null: no tracing)
+    trace_buffer *     _creation_tracer_ = nullptr; ///< Trace buffer of the creations (null: creations are not traced)
+    std::string        _label_;         ///< Label of the factory
+    mutable std::mutex _mutex_;         ///< Mutex serializing the modifications
+    factory_record_list_type _records_; ///< Records of the registered factories
+    factory_record_list_type _retired_; ///< Records of the unregistered factories, kept alive for concurrent lookups
+    detail::string_arena _ids_;         ///< Registration IDs of the registered and retired factories
+    detail::string_arena _texts_;       ///< Descriptions and categories of the registered and retired factories
+    factory_map_type   _registered_;    ///< Dictionary of registered factories, ordered by ID
+    factory_index_type _index_;         ///< Hashed index of the registered factories, used for lookups
+    type_index_type    _types_;         ///< Reverse index of the registered factories, by type
+    category_index_type _categories_;   ///< Index of the registered factories, by category
+    std::atomic<std::size_t>   _size_{0};    ///< Number of registered factories
+    std::atomic<std::uint64_t> _version_{0}; ///< Version, incremented by each modification
+    factory_type_index_type _type_index_; ///< Hashed reverse index of the registered factories, used for lookups
+    bool               _type_name_clashes_ = false; ///< Flag set if distinct registered classes share the same name
+    handle_slot_array_type  _slots_;      ///< Slots referenced by handles
+    std::unique_ptr<const factory_frozen_index_type> _frozen_index_; ///< Immutable index of the frozen register
+    std::atomic<const factory_frozen_index_type *>   _frozen_{nullptr}; ///< Published immutable index (null if not frozen)
+    std::atomic<bool>       _sealed_{false}; ///< Frozen register flag
+    std::vector<std::uint32_t> _free_slots_; ///< Indexes of the free slots
+    std::shared_ptr<plugin_manifest> _plugins_; ///< Manifest of the plugin libraries loaded on demand
+    void (*_flush_pending_)() = nullptr; ///< Function performing the pending auto-registrations (system registers only)
+
+    template <class> friend class detail::system_register_holder;
+    template <class> friend class detail::auto_registration_list;
 
   };
 
@@ -157,64 +710,93 @@ namespace bxfactories {
 
 namespace bxfactories {
 
-  /// \brief Utility template class to enable auto-(un)registration of a derived class in a system factory register of a base class
+  /*! \brief Utility template class to enable auto-(un)registration of a derived class in a system factory register of a base class
+   *
+   *  The registration is deferred: the constructor, which runs during the
+   *  static initialization, only links a node in the list of the pending
+   *  registrations of the base class. The class is registered on the next
+   *  access to the system register (see detail::auto_registration_list).
+   *  Registration IDs given as factory IDs must have static storage
+   *  duration (typically string literals) and are not copied; other IDs
+   *  are copied by the registrator.
+   */
   template <class BaseType, class DerivedType>
   class _system_factory_registrator
   {
   public:
 
-    /// Constructor
+    static_assert(std::is_base_of<BaseType, DerivedType>::value,
+                  "bxfactories::_system_factory_registrator: the class does not inherit the base class!");
+
+    typedef typename BaseType::factory_register_type           register_type;
+    typedef detail::auto_registration_list<BaseType>           list_type;
+    typedef typename list_type::node_type                      node_type;
+
+    /// Constructor, the registration ID being copied
     _system_factory_registrator(const std::string & type_id_)
-      : _type_info_(typeid(DerivedType))
-      , _type_id_( type_id_)
+      : _type_id_(type_id_)
+    {
+      _node_.type_id = factory_id(_type_id_.data(), _type_id_.size());
+      _node_.apply = &_system_factory_registrator::_apply_;
+      list_type::link(_node_);
+      return;
+    }
+
+    /// Constructor from a factory ID with static storage duration, whose hash is stored by the register
+    _system_factory_registrator(const factory_id & type_id_)
     {
-      this->_trigger_factory_registration_();
+      _node_.type_id = type_id_;
+      _node_.apply = &_system_factory_registrator::_apply_;
+      list_type::link(_node_);
       return;
     }
 
+    /// Not copyable
+    _system_factory_registrator(const _system_factory_registrator &) = delete;
+
+    /// Not assignable
+    _system_factory_registrator & operator=(const _system_factory_registrator &) = delete;
+
     /// Destructor
     ~_system_factory_registrator()
     {
-      this->_trigger_factory_unregistration_();
+      list_type::unlink(_node_);
       return;
     }
 
     /// Return registered type id
-    const std::string & get_type_id()const
+    ///
+    /// The registrator of an ID given as a factory ID only copies it in a
+    /// std::string on the first call.
+    const std::string & get_type_id() const
     {
+      std::call_once(_type_id_copied_, [this]() {
+          if (_type_id_.empty()) _type_id_.assign(_node_.type_id.data(), _node_.type_id.size());
+          return;
+        });
       return _type_id_;
     }
 
-  private:
-
-    /// Factory registration
-    void _trigger_factory_registration_()
+    /// Return registered type id as null terminated characters, without copying it
+    const char * get_raw_type_id() const
     {
-      if (!std::is_base_of<BaseType, DerivedType>::value) {
-        std::ostringstream error_message;
-        error_message << "Class ID '" << _type_id_ << "' cannot be registered in register '"
-                      << BaseType::grab_system_factory_register().get_label() << "' !";
-        throw std::logic_error(error_message.str());
-      }
-      BaseType::grab_system_factory_register().register_factory(_type_id_,
-                                                                boost::factory<DerivedType*>(),
-                                                                typeid(DerivedType));
-      return;
+      return _node_.type_id.data();
     }
 
-    /// Factory unregistration
-    void _trigger_factory_unregistration_()
+  private:
+
+    /// Factory registration
+    static void _apply_(register_type & register_, const factory_id & type_id_)
     {
-      if (BaseType::grab_system_factory_register().has(_type_id_)) {
-        BaseType::grab_system_factory_register().unregister_factory(_type_id_);
-      }
+      register_.template register_factory<DerivedType>(type_id_);
       return;
     }
 
   private:
 
-    const std::type_info & _type_info_; //!< System type info associated to the class of which the factory is auto-registered
-    std::string _type_id_; //!< The registration type unique identifier of the auto-registered class
+    mutable std::string _type_id_; //!< Copy of the registration ID (built on demand for factory IDs)
+    mutable std::once_flag _type_id_copied_; //!< Flag of the on demand copy of the registration ID
+    node_type _node_; //!< Node in the list of pending registrations
     
   };
 
@@ -0,0 +1,201 @@
+/// \file bxfactories/factory_batch.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_FACTORY_BATCH_HPP
+#define BXFACTORIES_FACTORY_BATCH_HPP
+
+// Standard Library:
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// This project:
+#include <bxfactories/factory_stats.hpp>
+
+namespace bxfactories {
+
+  template <class BaseType, class... Args>
+  class factory_register;
+
+  /*! \brief Objects of one registered class, created together in contiguous storage
+   *
+   *  A batch is obtained from factory_register<>::create_batch(). It owns
+   *  its objects, which are stored one after the other, with the proper
+   *  alignment, in a single arena, and gives access to them through base
+   *  pointers in creation order. The objects are destroyed, in reverse
+   *  order, with the batch or by clear(). A batch can be moved, not copied.
+   */
+  template <class BaseType>
+  class factory_batch
+  {
+  public:
+
+    typedef BaseType                    base_type;
+    typedef base_type * const *         const_iterator;
+
+    /// Default constructor (empty batch)
+    factory_batch() = default;
+
+    /// Not copyable
+    factory_batch(const factory_batch &) = delete;
+
+    /// Not assignable
+    factory_batch & operator=(const factory_batch &) = delete;
+
+    /// Move constructor
+    factory_batch(factory_batch && other_)
+      : _arena_(other_._arena_)
+      , _objects_(std::move(other_._objects_))
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+      , _stats_(std::move(other_._stats_))
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+    {
+      other_._arena_ = nullptr;
+      other_._objects_.clear();
+      return;
+    }
+
+    /// Move assignment
+    factory_batch & operator=(factory_batch && other_)
+    {
+      if (this != &other_) {
+        this->clear();
+        _arena_ = other_._arena_;
+        _objects_ = std::move(other_._objects_);
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+        _stats_ = std::move(other_._stats_);
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+        other_._arena_ = nullptr;
+        other_._objects_.clear();
+      }
+      return *this;
+    }
+
+    /// Destructor
+    ~factory_batch()
+    {
+      this->clear();
+      return;
+    }
+
+    /// Return the number of objects
+    std::size_t size() const
+    {
+      return _objects_.size();
+    }
+
+    /// Return true if the batch has no object
+    bool empty() const
+    {
+      return _objects_.empty();
+    }
+
+    /// Return true if the objects are stored in a single arena
+    bool is_contiguous() const
+    {
+      return _arena_ != nullptr;
+    }
+
+    /// Return the object at given position (no bound check)
+    base_type * operator[](std::size_t i_) const
+    {
+      return _objects_[i_];
+    }
+
+    /// Return the array of the base pointers of the objects
+    base_type * const * data() const
+    {
+      return _objects_.data();
+    }
+
+    const_iterator begin() const
+    {
+      return _objects_.data();
+    }
+
+    const_iterator end() const
+    {
+      return _objects_.data() + _objects_.size();
+    }
+
+    /// Destroy the objects and release their storage
+    void clear()
+    {
+      for (std::size_t i = _objects_.size(); i-- > 0; ) {
+        if (_arena_ != nullptr) {
+          _objects_[i]->~base_type();
+        } else {
+          delete _objects_[i];
+        }
+      }
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+      if (_stats_ && !_objects_.empty()) _stats_->on_destroyed(_objects_.size());
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+      _objects_.clear();
+      ::operator delete(_arena_);
+      _arena_ = nullptr;
+      return;
+    }
+
+  private:
+
+    /// Allocate the arena for a given number of objects, return the first slot
+    char * _allocate_(std::size_t count_, std::size_t size_, std::size_t alignment_, std::size_t & stride_)
+    {
+      stride_ = (size_ + alignment_ - 1) / alignment_ * alignment_;
+      std::size_t bytes = count_ * stride_ + alignment_ - 1;
+      _arena_ = ::operator new(bytes);
+      void * first = _arena_;
+      std::align(alignment_, count_ * stride_, first, bytes);
+      _objects_.reserve(count_);
+      return static_cast<char *>(first);
+    }
+
+  private:
+
+    void *                   _arena_ = nullptr; ///< Storage of the objects (null if they were allocated one by one)
+    std::vector<base_type *> _objects_;         ///< Objects in creation order
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+    std::shared_ptr<detail::factory_stats> _stats_; ///< Creation statistics of the class of the objects
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+
+    template <class, class...> friend class factory_register;
+
+  };
+
+  namespace detail {
+
+    /// \brief Pass an argument to each of the constructors of a batch
+    ///
+    /// Lvalue references are passed as is, other arguments are copied for each object.
+    template <class Arg>
+    struct batch_argument
+    {
+      typedef typename std::decay<Arg>::type value_type;
+      static value_type pass(const value_type & arg_)
+      {
+        return arg_;
+      }
+    };
+
+    template <class Arg>
+    struct batch_argument<Arg &>
+    {
+      static Arg & pass(Arg & arg_)
+      {
+        return arg_;
+      }
+    };
+
+  } // end of namespace detail
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_FACTORY_BATCH_HPP
@@ -0,0 +1,294 @@
+/// \file bxfactories/factory_function.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_FACTORY_FUNCTION_HPP
+#define BXFACTORIES_FACTORY_FUNCTION_HPP
+
+// Standard Library:
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace bxfactories {
+
+  /*! \brief Callable object which creates new objects of a given base type
+   *
+   *  The arguments of the call, if any, are forwarded to the constructor
+   *  of the created object.
+   *
+   *  A factory function is made of a pointer to a trampoline function,
+   *  which performs the creation, and of one word of target data:
+   *
+   *  - the default constructing factory of a class, obtained with
+   *    make<DerivedType>(), needs no target: calling it costs a single
+   *    indirect call to a function which invokes the new operator,
+   *  - small trivially copyable callables (function pointers, lambdas
+   *    without captures, empty function objects like boost::factory...)
+   *    are stored inline in the target word,
+   *  - other function objects carry some state: they are moved once into
+   *    a reference counted heap block, shared by all the copies of the
+   *    factory function.
+   *
+   *  Copying a factory function never allocates.
+   *
+   *  The kind of target is stored in the factory function: trampolines are
+   *  never compared, as the addresses of the instantiations of a trampoline
+   *  may differ between shared libraries (plugins).
+   */
+  template <class ResultType, class... Args>
+  class factory_function
+  {
+  public:
+
+    typedef ResultType result_type;
+
+    /// Default constructor (empty factory function)
+    factory_function()
+      : _invoke_(&_call_empty_)
+      , _kind_(kind_empty)
+    {
+      _target_.state = nullptr;
+      return;
+    }
+
+    /// Constructor of an empty factory function
+    factory_function(std::nullptr_t)
+      : factory_function()
+    {
+      return;
+    }
+
+    /// Constructor from a callable object taking the arguments and returning a pointer convertible to result_type*
+    template <class Functor,
+              class = typename std::enable_if<!std::is_same<typename std::decay<Functor>::type, factory_function>::value>::type,
+              class = typename std::enable_if<std::is_convertible<decltype(std::declval<typename std::decay<Functor>::type &>()(std::declval<Args>()...)), result_type *>::value>::type>
+    factory_function(Functor && functor_)
+      : factory_function()
+    {
+      typedef typename std::decay<Functor>::type functor_type;
+      this->_assign_(std::forward<Functor>(functor_),
+                     std::integral_constant<bool, _is_inline_<functor_type>::value>());
+      return;
+    }
+
+    /// Copy constructor
+    factory_function(const factory_function & other_)
+      : _invoke_(other_._invoke_)
+      , _target_(other_._target_)
+      , _kind_(other_._kind_)
+    {
+      if (this->is_stateful()) _target_.state->count.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    /// Move constructor
+    factory_function(factory_function && other_)
+      : _invoke_(other_._invoke_)
+      , _target_(other_._target_)
+      , _kind_(other_._kind_)
+    {
+      other_._invoke_ = &_call_empty_;
+      other_._target_.state = nullptr;
+      other_._kind_ = kind_empty;
+      return;
+    }
+
+    /// Destructor
+    ~factory_function()
+    {
+      this->_release_();
+      return;
+    }
+
+    /// Assignment
+    factory_function & operator=(factory_function other_)
+    {
+      std::swap(_invoke_, other_._invoke_);
+      std::swap(_target_, other_._target_);
+      std::swap(_kind_, other_._kind_);
+      return *this;
+    }
+
+    /// Return the factory function which constructs objects of a given class from the arguments
+    template <class DerivedType>
+    static factory_function make()
+    {
+      static_assert(std::is_convertible<DerivedType *, result_type *>::value,
+                    "bxfactories::factory_function<>::make: the class does not inherit the result type!");
+      static_assert(std::is_constructible<DerivedType, Args...>::value,
+                    "bxfactories::factory_function<>::make: the class is not constructible from the arguments!");
+      factory_function f;
+      f._invoke_ = &_call_new_<DerivedType>;
+      f._kind_ = kind_stateless;
+      return f;
+    }
+
+    /// Create a new object, forwarding the arguments to its constructor
+    ///
+    /// Throws std::bad_function_call if the factory function is empty.
+    result_type * operator()(Args... args_) const
+    {
+      return _invoke_(_target_, std::forward<Args>(args_)...);
+    }
+
+    /// Return true if the factory function is not empty
+    explicit operator bool() const
+    {
+      return _kind_ != kind_empty;
+    }
+
+    /// Return true if the factory function holds a function object in a heap block
+    bool is_stateful() const
+    {
+      return _kind_ == kind_stateful;
+    }
+
+    friend bool operator==(const factory_function & f_, std::nullptr_t) { return !f_; }
+    friend bool operator==(std::nullptr_t, const factory_function & f_) { return !f_; }
+    friend bool operator!=(const factory_function & f_, std::nullptr_t) { return static_cast<bool>(f_); }
+    friend bool operator!=(std::nullptr_t, const factory_function & f_) { return static_cast<bool>(f_); }
+
+  private:
+
+    /// \brief Reference counted heap block holding a function object
+    struct state_type
+    {
+      state_type() = default;
+      virtual ~state_type() = default;
+      virtual result_type * create(Args &&... args_) = 0;
+      std::atomic<long> count{1}; ///< Number of factory functions sharing the block
+    };
+
+    template <class Functor>
+    struct functor_state_type
+      : public state_type
+    {
+      explicit functor_state_type(Functor && functor_)
+        : functor(std::move(functor_))
+      {
+        return;
+      }
+
+      explicit functor_state_type(const Functor & functor_)
+        : functor(functor_)
+      {
+        return;
+      }
+
+      result_type * create(Args &&... args_) override
+      {
+        return functor(std::forward<Args>(args_)...);
+      }
+
+      Functor functor;
+    };
+
+    /// \brief Kind of target
+    enum kind_type : unsigned char {
+      kind_empty = 0,     ///< No target, calls throw
+      kind_stateless = 1, ///< No target or an inline callable
+      kind_stateful = 2   ///< Function object in a reference counted heap block
+    };
+
+    /// \brief Target data
+    union target_type
+    {
+      state_type *  state; ///< Heap block of a stateful function object
+      unsigned char data[sizeof(void *)]; ///< Storage of an inline callable
+    };
+
+    typedef result_type * (*invoke_type)(const target_type &, Args &&...);
+
+    /// Check if a callable can be stored in the target word
+    template <class Functor>
+    struct _is_inline_
+      : std::integral_constant<bool,
+                               std::is_trivially_copyable<Functor>::value
+                               && sizeof(Functor) <= sizeof(target_type)
+                               && alignof(target_type) % alignof(Functor) == 0>
+    {};
+
+    template <class Functor>
+    void _assign_(Functor && functor_, std::true_type)
+    {
+      typedef typename std::decay<Functor>::type functor_type;
+      if (_is_null_(functor_)) return;
+      ::new (static_cast<void *>(_target_.data)) functor_type(std::forward<Functor>(functor_));
+      _invoke_ = &_call_inline_<functor_type>;
+      _kind_ = kind_stateless;
+      return;
+    }
+
+    template <class Functor>
+    void _assign_(Functor && functor_, std::false_type)
+    {
+      typedef typename std::decay<Functor>::type functor_type;
+      _target_.state = new functor_state_type<functor_type>(std::forward<Functor>(functor_));
+      _invoke_ = &_call_state_;
+      _kind_ = kind_stateful;
+      return;
+    }
+
+    /// Null function pointers make empty factory functions
+    template <class Functor>
+    static bool _is_null_(const Functor & functor_, typename std::enable_if<std::is_pointer<Functor>::value>::type * = nullptr)
+    {
+      return functor_ == nullptr;
+    }
+
+    template <class Functor>
+    static bool _is_null_(const Functor &, typename std::enable_if<!std::is_pointer<Functor>::value>::type * = nullptr)
+    {
+      return false;
+    }
+
+    void _release_()
+    {
+      if (this->is_stateful() && _target_.state->count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete _target_.state;
+      }
+      return;
+    }
+
+    static result_type * _call_empty_(const target_type &, Args &&...)
+    {
+      throw std::bad_function_call();
+    }
+
+    template <class DerivedType>
+    static result_type * _call_new_(const target_type &, Args &&... args_)
+    {
+      return new DerivedType(std::forward<Args>(args_)...);
+    }
+
+    template <class Functor>
+    static result_type * _call_inline_(const target_type & target_, Args &&... args_)
+    {
+      // Callables may have a non const call operator, so a copy is invoked:
+      Functor functor(*reinterpret_cast<const Functor *>(target_.data));
+      return functor(std::forward<Args>(args_)...);
+    }
+
+    static result_type * _call_state_(const target_type & target_, Args &&... args_)
+    {
+      return target_.state->create(std::forward<Args>(args_)...);
+    }
+
+  private:
+
+    invoke_type _invoke_; ///< Trampoline performing the creation
+    target_type _target_; ///< Target data of the trampoline
+    kind_type   _kind_;   ///< Kind of target
+
+  };
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_FACTORY_FUNCTION_HPP
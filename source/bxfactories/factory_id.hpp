@@ -0,0 +1,138 @@
+/// \file bxfactories/factory_id.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_FACTORY_ID_HPP
+#define BXFACTORIES_FACTORY_ID_HPP
+
+// Standard Library:
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// This project:
+#include <bxfactories/id_index.hpp>
+
+namespace bxfactories {
+
+  /*! \brief Registration ID with a precomputed hash
+   *
+   *  A factory ID refers to characters it does not own (typically a string
+   *  literal) and carries their hash. Lookups of a factory register by a
+   *  factory ID neither hash nor copy the ID: the hash selects the entry and
+   *  one comparison of the ID rules out collisions.
+   *
+   *  The hash is only guaranteed to be computed at compile time when the ID
+   *  is built in a constant context (a constexpr variable) or with the
+   *  BXFACTORIES_FACTORY_ID macro; elsewhere, the compiler may compute it
+   *  at run time, once per evaluation of the expression.
+   *  \code
+   *  using namespace bxfactories::literals;
+   *  constexpr bxfactories::factory_id foo_id = "examples::foo_runner"_fid;
+   *  i_runner * r = i_runner::get_system_factory_register().get(foo_id)();
+   *  \endcode
+   */
+  class factory_id
+  {
+  public:
+
+    /// Default constructor (empty ID)
+    constexpr factory_id()
+      : _data_("")
+      , _size_(0)
+      , _hash_(detail::constant_hash_id("", 0))
+    {
+    }
+
+    /// Constructor from a character range
+    constexpr factory_id(const char * id_, std::size_t size_)
+      : _data_(id_)
+      , _size_(size_)
+      , _hash_(detail::constant_hash_id(id_, size_))
+    {
+    }
+
+    /// Constructor from a character range and its hash, as computed by detail::hash_id()
+    constexpr factory_id(const char * id_, std::size_t size_, std::uint64_t hash_)
+      : _data_(id_)
+      , _size_(size_)
+      , _hash_(hash_)
+    {
+    }
+
+    /// Constructor from a string literal
+    template <std::size_t N>
+    constexpr explicit factory_id(const char (&id_)[N])
+      : factory_id(id_, N - 1)
+    {
+    }
+
+    /// Return the characters of the ID (not null terminated)
+    constexpr const char * data() const
+    {
+      return _data_;
+    }
+
+    /// Return the number of characters of the ID
+    constexpr std::size_t size() const
+    {
+      return _size_;
+    }
+
+    /// Return the hash of the ID
+    constexpr std::uint64_t hash() const
+    {
+      return _hash_;
+    }
+
+    /// Return a view on the ID
+    id_view_type view() const
+    {
+      return id_view_type(_data_, _size_);
+    }
+
+  private:
+
+    const char *  _data_; ///< Characters of the ID
+    std::size_t   _size_; ///< Number of characters of the ID
+    std::uint64_t _hash_; ///< Hash of the ID
+
+  };
+
+  namespace detail {
+
+    /// Return the length of a string literal (pointers are rejected)
+    template <std::size_t N>
+    constexpr std::size_t literal_id_length(const char (&)[N])
+    {
+      return N - 1;
+    }
+
+  } // end of namespace detail
+
+  namespace literals {
+
+    /// Build a factory ID from a string literal: "examples::foo_runner"_fid
+    ///
+    /// The hash is computed at compile time in constant contexts only.
+    constexpr factory_id operator""_fid(const char * id_, std::size_t size_)
+    {
+      return factory_id(id_, size_);
+    }
+
+  } // end of namespace literals
+
+} // end of namespace bxfactories
+
+/// Factory ID of a string literal, whose hash is always computed at compile time
+#define BXFACTORIES_FACTORY_ID(Id)                                      \
+  ::bxfactories::factory_id(Id,                                         \
+                            ::bxfactories::detail::literal_id_length(Id), \
+                            ::std::integral_constant< ::std::uint64_t,  \
+                            ::bxfactories::detail::constant_hash_id(Id, ::bxfactories::detail::literal_id_length(Id))>::value) \
+  /**/
+
+#endif // BXFACTORIES_FACTORY_ID_HPP
@@ -1,7 +1,7 @@
 /// \file bxfactories/factory_macros.hpp
 /* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
  * Creation date : 2020-03-18
- * Last modified : 2020-03-18
+ * Last modified : 2026-10-17
  *
  */
 #ifndef BXFACTORIES_FACTORY_MACROS_HPP
@@ -54,6 +54,28 @@
 /// // In implementation, e.g. derived2.cpp:
 /// BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_IMPLEMENTATION(Base, Derived2, "Derived2")
 /// \endcode
+///
+/// Objects can also be created from constructor arguments, declared once with the
+/// base class and forwarded by the factories to the constructor of the derived classes:
+/// \code
+/// // In header, e.g. base.hpp:
+/// class Base {
+/// public:
+///   Base(const std::string & name_, properties && config_);
+///   virtual ~Base() = default;
+///   BXFACTORIES_FACTORY_SYSTEM_REGISTER_INTERFACE_WITH_ARGS(Base, const std::string &, properties &&)
+/// };
+///
+/// // In header, e.g. derived1.hpp:
+/// class Derived1 : public Base {
+/// public:
+///   Derived1(const std::string & name_, properties && config_);
+///   BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_INTERFACE(Base, Derived1)
+/// };
+///
+/// // Usage:
+/// Base * obj = Base::get_system_factory_register().get("Derived1")("obj", std::move(config));
+/// \endcode
 
 /// Alias for a factory register associated to a base class
 #define BXFACTORIES_FACTORY_INTERFACE(BaseType)                         \
@@ -61,6 +83,12 @@
   typedef ::bxfactories::factory_register< BaseType > factory_register_type; \
   /**/
 
+/// Alias for a factory register associated to a base class, with a creation signature
+#define BXFACTORIES_FACTORY_INTERFACE_WITH_ARGS(BaseType, ...)          \
+  public:                                                               \
+  typedef ::bxfactories::factory_register< BaseType , __VA_ARGS__ > factory_register_type; \
+  /**/
+
 /// Declaration of a system (allocator/functor) factory register as a static member of a base class and static accessor methods
 #define BXFACTORIES_FACTORY_SYSTEM_REGISTER_INTERFACE(BaseType)         \
   BXFACTORIES_FACTORY_INTERFACE(BaseType)                               \
@@ -70,15 +98,23 @@
   static const factory_register_type& get_system_factory_register();    \
   /**/
 
+/// Declaration of a system factory register, with a creation signature, and static accessor methods
+#define BXFACTORIES_FACTORY_SYSTEM_REGISTER_INTERFACE_WITH_ARGS(BaseType, ...) \
+  BXFACTORIES_FACTORY_INTERFACE_WITH_ARGS(BaseType, __VA_ARGS__)        \
+  public:                                                               \
+  typedef ::std::unique_ptr< factory_register_type > scoped_factory_register_type; \
+  static factory_register_type& grab_system_factory_register();         \
+  static const factory_register_type& get_system_factory_register();    \
+  /**/
+
 /// Instantiate the system (allocator/functor) factory register and its associated accessors
 #define BXFACTORIES_FACTORY_SYSTEM_REGISTER_IMPLEMENTATION(BaseType, RegisterLabel) \
   BaseType::factory_register_type& BaseType::grab_system_factory_register() \
   {                                                                     \
-    static scoped_factory_register_type _system_factory_register;       \
-    if (!_system_factory_register) {                                    \
-      _system_factory_register.reset(new BaseType::factory_register_type(RegisterLabel, 0)); \
-    }                                                                   \
-    return *_system_factory_register.get();                             \
+    /* The initialization of a local static object is thread-safe */    \
+    static ::bxfactories::detail::system_register_holder< BaseType > _system_factory_register(RegisterLabel); \
+    /* Pending auto-registrations are performed on access */            \
+    return _system_factory_register.grab();                             \
   }                                                                     \
   const BaseType::factory_register_type& BaseType::get_system_factory_register() \
   {                                                                     \
@@ -105,8 +141,11 @@ public:                                                                 \
  /**/
 
 /// Implementation macro of the automated registration for derived classes
+///
+/// The registration ID is preferably a string literal, which is referred to
+/// in place with its hash; other IDs (std::string, C strings) are copied.
 #define BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_IMPLEMENTATION(BaseType, DerivedType, DerivedTypeId) \
-  ::bxfactories::_system_factory_registrator< BaseType , DerivedType > DerivedType::_g_system_factory_auto_registration_(DerivedTypeId); \
+  ::bxfactories::_system_factory_registrator< BaseType , DerivedType > DerivedType::_g_system_factory_auto_registration_(::bxfactories::detail::auto_registration_id(DerivedTypeId)); \
   const std::string & DerivedType::system_factory_auto_registration_id() \
   {                                                                     \
     static const std::string _id(DerivedTypeId);                        \
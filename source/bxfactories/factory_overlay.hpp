@@ -0,0 +1,284 @@
+/// \file bxfactories/factory_overlay.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_FACTORY_OVERLAY_HPP
+#define BXFACTORIES_FACTORY_OVERLAY_HPP
+
+// Standard Library:
+#include <list>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include <bxfactories/id_index.hpp>
+
+namespace bxfactories {
+
+  /*! \brief Restricted view of a factory register, with local additions
+   *
+   *  An overlay references a parent register (or another overlay) without
+   *  copying any of its records: lookups are resolved first among the
+   *  factories added locally, then in the parent, through the whole chain
+   *  of overlays. Factories of the parent can be restricted by an allow-list
+   *  or hidden by a deny-list of IDs. Building an overlay thus costs only
+   *  its local entries, and an overlay with no local factory owns no register.
+   *
+   *  Filters and local additions are set up before the overlay is shared:
+   *  lookups are then thread-safe, as those of the parent. The parent must
+   *  outlive the overlay. Handles are specific to each register and are not
+   *  provided by overlays.
+   */
+  template <class BaseType, class... Args>
+  class factory_overlay
+  {
+  public:
+
+    typedef factory_register<BaseType, Args...>         register_type;
+    typedef typename register_type::base_type           base_type;
+    typedef typename register_type::factory_type        factory_type;
+    typedef typename register_type::factory_record_type factory_record_type;
+
+    /// \brief Filter applied to the factories of the parent
+    enum filter_mode_type {
+      filter_none = 0,  ///< All factories of the parent are visible
+      filter_allow = 1, ///< Only the allowed factories of the parent are visible
+      filter_deny = 2   ///< All factories of the parent are visible, except the denied ones
+    };
+
+    /// Constructor on top of a register
+    explicit factory_overlay(const register_type & parent_, const std::string & label_ = "")
+      : _label_(label_)
+      , _parent_register_(&parent_)
+    {
+      return;
+    }
+
+    /// Constructor on top of another overlay
+    factory_overlay(const factory_overlay & parent_, const std::string & label_)
+      : _label_(label_)
+      , _parent_overlay_(&parent_)
+    {
+      return;
+    }
+
+    /// Not copyable (an overlay is built on top of another one with a label)
+    factory_overlay(const factory_overlay &) = delete;
+
+    /// Not assignable
+    factory_overlay & operator=(const factory_overlay &) = delete;
+
+    /// Destructor
+    ~factory_overlay() = default;
+
+    /// Return the label of the overlay
+    const std::string & get_label() const
+    {
+      return _label_;
+    }
+
+    /// Return the filter applied to the factories of the parent
+    filter_mode_type get_filter_mode() const
+    {
+      return _filter_mode_;
+    }
+
+    /// Make visible a factory of the parent (all other factories of the parent are hidden)
+    void allow(const std::string & id_)
+    {
+      this->_add_filter_(id_, filter_allow, "allow");
+      return;
+    }
+
+    /// Hide a factory of the parent
+    void deny(const std::string & id_)
+    {
+      this->_add_filter_(id_, filter_deny, "deny");
+      return;
+    }
+
+    /// Register a local factory, which hides any factory of the parent with the same ID
+    template <class DerivedType>
+    void register_factory(const std::string & id_,
+                          const std::string & description_ = "",
+                          const std::string & category_ = "")
+    {
+      this->_grab_local_().template register_factory<DerivedType>(id_, description_, category_);
+      return;
+    }
+
+    /// Register a supplied local factory, which hides any factory of the parent with the same ID
+    void register_factory(const std::string & id_,
+                          const factory_type & factory_,
+                          const std::type_info & tinfo_,
+                          const std::string & description_ = "",
+                          const std::string & category_ = "")
+    {
+      this->_grab_local_().register_factory(id_, factory_, tinfo_, description_, category_);
+      return;
+    }
+
+    /// Register a local prototype, which hides any factory of the parent with the same ID
+    template <class DerivedType>
+    void register_prototype(const std::string & id_,
+                            const std::shared_ptr<const DerivedType> & prototype_,
+                            const std::string & description_ = "",
+                            const std::string & category_ = "")
+    {
+      this->_grab_local_().register_prototype(id_, prototype_, description_, category_);
+      return;
+    }
+
+    /// Remove a local factory
+    void unregister_factory(const std::string & id_)
+    {
+      if (!_local_ || !_local_->has(id_)) {
+        std::ostringstream error_message;
+        error_message << "bxfactory::factory_overlay<>::unregister_factory(...): " << "Class ID '" << id_ << "' is not registered locally in overlay '" << _label_ << "' !";
+        throw std::logic_error(error_message.str());
+      }
+      _local_->unregister_factory(id_);
+      return;
+    }
+
+    /// Return the record of a visible factory, or null
+    const factory_record_type * find(const id_view_type & id_) const
+    {
+      if (_local_) {
+        const factory_record_type * found = _local_->find(id_);
+        if (found != nullptr) return found;
+      }
+      if (!this->_is_visible_(id_)) return nullptr;
+      return this->_find_in_parent_(id_);
+    }
+
+    /// Check if a factory is visible
+    bool has(const id_view_type & id_) const
+    {
+      return this->find(id_) != nullptr;
+    }
+
+    /// Return a visible factory, or null
+    const factory_type * try_get(const id_view_type & id_) const
+    {
+      const factory_record_type * found = this->find(id_);
+      return found == nullptr ? nullptr : &found->fact;
+    }
+
+    /// Return a visible factory
+    const factory_type & get(const id_view_type & id_) const
+    {
+      return this->get_record(id_).fact;
+    }
+
+    /// Return the record of a visible factory
+    const factory_record_type & get_record(const id_view_type & id_) const
+    {
+      const factory_record_type * found = this->find(id_);
+      if (found == nullptr) {
+        std::ostringstream error_message;
+        error_message << "bxfactory::factory_overlay<>::get_record(...): " << "Class ID '" << id_ << "' is not visible in overlay '" << _label_ << "' !";
+        throw std::logic_error(error_message.str());
+      }
+      return *found;
+    }
+
+    /// Create an object from a visible factory, or return null
+    ///
+    /// The object is created by the register which owns the factory, so that
+    /// its tracer and its creation statistics see the creation.
+    base_type * try_create(const id_view_type & id_, Args... args_) const
+    {
+      if (_local_ && _local_->find(id_) != nullptr) {
+        return _local_->try_create(id_, std::forward<Args>(args_)...);
+      }
+      if (!this->_is_visible_(id_)) return nullptr;
+      if (_parent_overlay_ != nullptr) {
+        return _parent_overlay_->try_create(id_, std::forward<Args>(args_)...);
+      }
+      return _parent_register_->try_create(id_, std::forward<Args>(args_)...);
+    }
+
+    /// Build the list of the IDs of the visible factories
+    void list_of_factory_ids(std::set<std::string> & ids_, bool clear_ = false) const
+    {
+      if (clear_) ids_.clear();
+      if (_filter_mode_ == filter_allow) {
+        // Only the allowed IDs are looked up in the parent:
+        for (const std::string & id : _filter_ids_) {
+          if (this->_find_in_parent_(id) != nullptr) ids_.insert(id);
+        }
+      } else {
+        std::set<std::string> parent_ids;
+        if (_parent_overlay_ != nullptr) {
+          _parent_overlay_->list_of_factory_ids(parent_ids);
+        } else {
+          _parent_register_->list_of_factory_ids(parent_ids);
+        }
+        for (const std::string & id : parent_ids) {
+          if (this->_is_visible_(id)) ids_.insert(ids_.end(), id);
+        }
+      }
+      if (_local_) _local_->list_of_factory_ids(ids_);
+      return;
+    }
+
+  private:
+
+    void _add_filter_(const std::string & id_, filter_mode_type mode_, const char * where_)
+    {
+      if (_filter_mode_ != filter_none && _filter_mode_ != mode_) {
+        std::ostringstream error_message;
+        error_message << "bxfactory::factory_overlay<>::" << where_ << "(...): " << "Overlay '" << _label_ << "' cannot both allow and deny factories !";
+        throw std::logic_error(error_message.str());
+      }
+      _filter_mode_ = mode_;
+      if (_filter_index_.find(id_) != nullptr) return;
+      _filter_ids_.push_back(id_);
+      // The index refers to the ID owned by the list:
+      _filter_index_.insert(_filter_ids_.back(), &_filter_ids_.back());
+      return;
+    }
+
+    bool _is_visible_(const id_view_type & id_) const
+    {
+      if (_filter_mode_ == filter_none) return true;
+      const bool listed = _filter_index_.find(id_) != nullptr;
+      return _filter_mode_ == filter_allow ? listed : !listed;
+    }
+
+    const factory_record_type * _find_in_parent_(const id_view_type & id_) const
+    {
+      return _parent_overlay_ != nullptr ? _parent_overlay_->find(id_) : _parent_register_->find(id_);
+    }
+
+    register_type & _grab_local_()
+    {
+      // The local register is only created with the first local factory:
+      if (!_local_) _local_.reset(new register_type(_label_));
+      return *_local_;
+    }
+
+  private:
+
+    std::string _label_; ///< Label of the overlay
+    const register_type *   _parent_register_ = nullptr; ///< Parent register (if any)
+    const factory_overlay * _parent_overlay_ = nullptr;  ///< Parent overlay (if any)
+    filter_mode_type _filter_mode_ = filter_none;        ///< Filter applied to the factories of the parent
+    std::list<std::string> _filter_ids_;                 ///< Allowed or denied IDs (with stable addresses)
+    detail::id_index<const std::string> _filter_index_;  ///< Hashed index of the allowed or denied IDs
+    std::unique_ptr<register_type> _local_;              ///< Register of the local factories (null if none)
+
+  };
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_FACTORY_OVERLAY_HPP
@@ -0,0 +1,314 @@
+/// \file bxfactories/factory_pool.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_FACTORY_POOL_HPP
+#define BXFACTORIES_FACTORY_POOL_HPP
+
+// Standard Library:
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include <bxfactories/object_pool.hpp>
+
+namespace bxfactories {
+
+  /*! \brief Pooled creation of objects from the factories of a register
+   *
+   *  Each registered class is given its own pool of storage, sized and
+   *  aligned after the class layout captured by register_factory<DerivedType>().
+   *  Objects are returned as unique pointers whose deleter gives the
+   *  storage back to the pool, so that a stable population of objects
+   *  which are repeatedly created and destroyed never reaches the global
+   *  allocator. Classes registered with a bare factory object have no
+   *  known layout: their objects are allocated by the factory and deleted.
+   *
+   *  A reset hook can be associated to a class: its released objects are
+   *  then kept alive, and recycled by the next creations which call the
+   *  hook, with the creation arguments, instead of constructing a new object.
+   *
+   *  A pool is not thread-safe by default: the usual setup is one pool per
+   *  thread (e.g. a thread_local pool), objects being released in the thread
+   *  which created them. The thread_safe flag protects the pool with a mutex
+   *  so that it can be shared. All objects must be released before the
+   *  destruction of their pool, and the register must outlive the pool.
+   */
+  template <class BaseType, class... Args>
+  class factory_pool
+  {
+  public:
+
+    static_assert(std::has_virtual_destructor<BaseType>::value,
+                  "bxfactories::factory_pool<>: the base class has no virtual destructor!");
+
+    typedef factory_register<BaseType, Args...>              register_type;
+    typedef typename register_type::base_type                base_type;
+    typedef typename register_type::factory_handle_type      factory_handle_type;
+    typedef typename register_type::factory_record_type      factory_record_type;
+
+    /// \brief Hook resetting a recycled object from the creation arguments
+    typedef void (*reset_hook_type)(base_type & object_, Args &&... args_);
+
+    enum flag_type {
+      thread_safe = 0x1
+    };
+
+  private:
+
+    struct type_pool_type;
+
+  public:
+
+    /// \brief Deleter which gives objects back to their pool
+    class deleter_type
+    {
+    public:
+
+      deleter_type() = default;
+
+      void operator()(base_type * object_) const
+      {
+        _pool_->release(object_);
+        return;
+      }
+
+    private:
+
+      explicit deleter_type(type_pool_type * pool_)
+        : _pool_(pool_)
+      {
+        return;
+      }
+
+      type_pool_type * _pool_ = nullptr;
+
+      friend class factory_pool;
+    };
+
+    /// \brief Owning pointer to a pooled object
+    typedef std::unique_ptr<base_type, deleter_type> pointer_type;
+
+    /// Constructor
+    explicit factory_pool(const register_type & register_, const unsigned int flags_ = 0x0)
+      : _register_(register_)
+    {
+      if (flags_ & thread_safe) _mutex_.reset(new std::mutex);
+      return;
+    }
+
+    /// Not copyable
+    factory_pool(const factory_pool &) = delete;
+
+    /// Not assignable
+    factory_pool & operator=(const factory_pool &) = delete;
+
+    /// Destructor
+    ~factory_pool() = default;
+
+    /// Return the register of the factories
+    const register_type & get_register() const
+    {
+      return _register_;
+    }
+
+    /// Associate a reset hook to the class registered under a given ID (null hook: no recycling)
+    void set_reset_hook(const id_view_type & id_, reset_hook_type hook_)
+    {
+      this->set_reset_hook(_register_.resolve(id_), hook_);
+      return;
+    }
+
+    /// Associate a reset hook to the class referenced by a handle (null hook: no recycling)
+    void set_reset_hook(const factory_handle_type & handle_, reset_hook_type hook_)
+    {
+      type_pool_type & pool = this->_grab_type_pool_(handle_);
+      std::unique_lock<std::mutex> lock = pool.lock();
+      pool.hook = hook_;
+      if (hook_ == nullptr) pool.purge();
+      return;
+    }
+
+    /// Create an object of the class registered under a given ID, forwarding the arguments to its constructor
+    pointer_type create(const id_view_type & id_, Args... args_)
+    {
+      return this->create(_register_.resolve(id_), std::forward<Args>(args_)...);
+    }
+
+    /// Create an object of the class referenced by a handle, forwarding the arguments to its constructor
+    pointer_type create(const factory_handle_type & handle_, Args... args_)
+    {
+      type_pool_type & pool = this->_grab_type_pool_(handle_);
+      return pointer_type(pool.acquire(std::forward<Args>(args_)...), deleter_type(&pool));
+    }
+
+  private:
+
+    /// \brief Pool of the objects of one registered class
+    struct type_pool_type
+    {
+      type_pool_type(const factory_record_type & record_, std::mutex * mutex_)
+        : record(record_)
+        , mutex(mutex_)
+      {
+        if (record_.construct != nullptr) {
+          storage.reset(new detail::object_pool(record_.type_size, record_.type_alignment));
+        }
+        return;
+      }
+
+      ~type_pool_type()
+      {
+        this->purge();
+        return;
+      }
+
+      std::unique_lock<std::mutex> lock()
+      {
+        return mutex != nullptr ? std::unique_lock<std::mutex>(*mutex) : std::unique_lock<std::mutex>();
+      }
+
+      base_type * acquire(Args &&... args_)
+      {
+        base_type * object = nullptr;
+        void * slot = nullptr;
+        {
+          std::unique_lock<std::mutex> guard = this->lock();
+          if (!recycled.empty()) {
+            object = recycled.back();
+            recycled.pop_back();
+          } else if (storage) {
+            slot = storage->allocate();
+          }
+        }
+        if (object != nullptr) {
+          try {
+            hook(*object, std::forward<Args>(args_)...);
+          } catch (...) {
+            this->destroy(object);
+            throw;
+          }
+          return object;
+        }
+        if (slot == nullptr) {
+          return record.fact(std::forward<Args>(args_)...);
+        }
+        try {
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+          const detail::factory_stats::clock_type::time_point start = detail::factory_stats::clock_type::now();
+          object = record.construct(slot, std::forward<Args>(args_)...);
+          record.stats->on_created(detail::factory_stats::elapsed_ns(start));
+#else
+          object = record.construct(slot, std::forward<Args>(args_)...);
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+        } catch (...) {
+          std::unique_lock<std::mutex> guard = this->lock();
+          storage->deallocate(slot);
+          throw;
+        }
+        // The base subobject is not necessarily at the start of the storage:
+        offset.store(reinterpret_cast<char *>(object) - static_cast<char *>(slot), std::memory_order_relaxed);
+        return object;
+      }
+
+      void release(base_type * object_)
+      {
+        if (object_ == nullptr) return;
+        {
+          std::unique_lock<std::mutex> guard = this->lock();
+          if (hook != nullptr) {
+            recycled.push_back(object_);
+            return;
+          }
+        }
+        this->destroy(object_);
+        return;
+      }
+
+      void destroy(base_type * object_)
+      {
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+        if (record.stats) record.stats->on_destroyed();
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+        if (!storage) {
+          delete object_;
+          return;
+        }
+        char * slot = reinterpret_cast<char *>(object_) - offset.load(std::memory_order_relaxed);
+        object_->~base_type();
+        std::unique_lock<std::mutex> guard = this->lock();
+        storage->deallocate(slot);
+        return;
+      }
+
+      /// Destroy the recycled objects (the pool must be locked)
+      void purge()
+      {
+        std::vector<base_type *> objects;
+        objects.swap(recycled);
+#ifdef BXFACTORIES_WITH_INSTRUMENTATION
+        if (record.stats && !objects.empty()) record.stats->on_destroyed(objects.size());
+#endif // BXFACTORIES_WITH_INSTRUMENTATION
+        for (base_type * object : objects) {
+          if (!storage) {
+            delete object;
+          } else {
+            char * slot = reinterpret_cast<char *>(object) - offset.load(std::memory_order_relaxed);
+            object->~base_type();
+            storage->deallocate(slot);
+          }
+        }
+        return;
+      }
+
+      const factory_record_type & record;           ///< Record of the class
+      std::mutex *                mutex;            ///< Mutex of the pool (null if not thread-safe)
+      std::unique_ptr<detail::object_pool> storage; ///< Storage of the objects (null if the class layout is unknown)
+      std::atomic<std::ptrdiff_t> offset{0};        ///< Offset of the base subobject in the storage
+      reset_hook_type             hook = nullptr;   ///< Reset hook of recycled objects
+      std::vector<base_type *>    recycled;         ///< Released objects kept for recycling
+    };
+
+    /// Return the pool of the class referenced by a handle
+    type_pool_type & _grab_type_pool_(const factory_handle_type & handle_)
+    {
+      std::unique_lock<std::mutex> lock;
+      if (_mutex_) lock = std::unique_lock<std::mutex>(*_mutex_);
+      if (handle_.slot < _pools_.size()) {
+        const std::unique_ptr<type_pool_type> & pool = _pools_[handle_.slot];
+        if (pool && pool->record.handle.generation == handle_.generation && _register_.has(handle_)) return *pool;
+      }
+      // Throws if the handle is not valid:
+      const factory_record_type & record = _register_.get_record(handle_);
+      if (handle_.slot >= _pools_.size()) _pools_.resize(handle_.slot + 1);
+      if (_pools_[handle_.slot]) {
+        // The slot now refers to another class, objects of the previous one may still be alive:
+        _retired_.push_back(std::move(_pools_[handle_.slot]));
+      }
+      _pools_[handle_.slot].reset(new type_pool_type(record, _mutex_.get()));
+      return *_pools_[handle_.slot];
+    }
+
+  private:
+
+    const register_type & _register_;   ///< Register of the factories
+    std::unique_ptr<std::mutex> _mutex_; ///< Mutex protecting a thread-safe pool
+    std::vector<std::unique_ptr<type_pool_type> > _pools_;   ///< Pools of the registered classes, by handle slot
+    std::vector<std::unique_ptr<type_pool_type> > _retired_; ///< Pools of classes which are not registered anymore
+
+  };
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_FACTORY_POOL_HPP
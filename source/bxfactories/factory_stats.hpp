@@ -0,0 +1,134 @@
+/// \file bxfactories/factory_stats.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_FACTORY_STATS_HPP
+#define BXFACTORIES_FACTORY_STATS_HPP
+
+// Standard Library:
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace bxfactories {
+
+  /*! \brief Snapshot of the creation statistics of a registered factory
+   *
+   *  Statistics are only collected when the library is compiled with the
+   *  BXFACTORIES_WITH_INSTRUMENTATION macro defined (consistently in all
+   *  translation units).
+   *
+   *  Objects deleted by the client code are not seen by the register, so
+   *  the number of live objects is not tracked: only the destructions
+   *  through the register (destroy(), destroy_in_place(), batches, pools)
+   *  are counted.
+   *
+   *  Bin #0 of the latency histogram counts creations which took less than
+   *  1 ns, bin #i (i > 0) those which took from 2^(i-1) ns to 2^i ns, the
+   *  last bin also counts all longer creations.
+   */
+  struct factory_stats_snapshot
+  {
+    static const std::size_t nbins = 32; ///< Number of bins of the latency histogram
+
+    std::string   type_id;               ///< Registration ID of the factory
+    std::uint64_t created = 0;           ///< Number of created objects
+    std::uint64_t destroyed = 0;         ///< Number of objects destroyed through the register
+    std::uint64_t total_latency_ns = 0;  ///< Cumulated construction time (ns)
+    std::array<std::uint64_t, nbins> latency_histogram{}; ///< Histogram of the construction times
+
+    /// Return the mean construction time (ns)
+    double mean_latency_ns() const
+    {
+      return created == 0 ? 0.0 : static_cast<double>(total_latency_ns) / created;
+    }
+
+    /// Return the upper bound of a bin of the latency histogram (ns)
+    static std::uint64_t bin_upper_bound_ns(std::size_t bin_)
+    {
+      return std::uint64_t(1) << bin_;
+    }
+
+  };
+
+  namespace detail {
+
+    /*! \brief Creation statistics of a registered factory
+     *
+     *  Counters are relaxed atomics: updates never lock, and a snapshot
+     *  taken while objects are created is consistent for each counter
+     *  but not necessarily across counters.
+     */
+    class factory_stats
+    {
+    public:
+
+      typedef std::chrono::steady_clock clock_type;
+
+      static const std::size_t nbins = factory_stats_snapshot::nbins;
+
+      /// Record the creation of an object which took a given time
+      void on_created(std::uint64_t latency_ns_)
+      {
+        _created_.fetch_add(1, std::memory_order_relaxed);
+        _total_latency_ns_.fetch_add(latency_ns_, std::memory_order_relaxed);
+        _histogram_[bin(latency_ns_)].fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+
+      /// Record the destruction of some objects through the register
+      void on_destroyed(std::uint64_t count_ = 1)
+      {
+        _destroyed_.fetch_add(count_, std::memory_order_relaxed);
+        return;
+      }
+
+      /// Return the time elapsed since a given time point (ns)
+      static std::uint64_t elapsed_ns(const clock_type::time_point & start_)
+      {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start_).count());
+      }
+
+      /// Return the bin of the latency histogram for a given time (ns)
+      static std::size_t bin(std::uint64_t latency_ns_)
+      {
+        std::size_t ibin = 0;
+        while (latency_ns_ != 0 && ibin + 1 < nbins) {
+          latency_ns_ >>= 1;
+          ibin++;
+        }
+        return ibin;
+      }
+
+      /// Copy the statistics in a snapshot
+      void snapshot(factory_stats_snapshot & snapshot_) const
+      {
+        snapshot_.created = _created_.load(std::memory_order_relaxed);
+        snapshot_.destroyed = _destroyed_.load(std::memory_order_relaxed);
+        snapshot_.total_latency_ns = _total_latency_ns_.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < nbins; i++) {
+          snapshot_.latency_histogram[i] = _histogram_[i].load(std::memory_order_relaxed);
+        }
+        return;
+      }
+
+    private:
+
+      std::atomic<std::uint64_t> _created_{0};          ///< Number of created objects
+      std::atomic<std::uint64_t> _destroyed_{0};        ///< Number of objects destroyed through the register
+      std::atomic<std::uint64_t> _total_latency_ns_{0}; ///< Cumulated construction time
+      std::array<std::atomic<std::uint64_t>, nbins> _histogram_{}; ///< Histogram of the construction times
+
+    };
+
+  } // end of namespace detail
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_FACTORY_STATS_HPP
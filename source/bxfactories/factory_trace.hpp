@@ -0,0 +1,394 @@
+/// \file bxfactories/factory_trace.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_FACTORY_TRACE_HPP
+#define BXFACTORIES_FACTORY_TRACE_HPP
+
+// Standard Library:
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// This project:
+#include <bxfactories/id_index.hpp>
+
+namespace bxfactories {
+
+  /// \brief Operation recorded by a trace event
+  enum class trace_operation : std::uint8_t {
+    registered   = 0, ///< A factory has been registered
+    unregistered = 1, ///< A factory has been unregistered
+    cleared      = 2, ///< A factory has been removed by clear()
+    import       = 3, ///< Factories are imported from another register (the ID is the label of the other register)
+    imported     = 4, ///< A factory has been imported
+    kept         = 5, ///< A registered factory has been kept rather than imported
+    replaced     = 6, ///< A registered factory has been replaced by an imported one
+    plugin_loaded = 7, ///< A plugin library has been loaded for a class ID
+    created      = 8, ///< An object has been created through the register
+    plugin_failed = 9 ///< A plugin library failed to load for a class ID (see plugin_manifest::get_load_error())
+  };
+
+  /// Return the name of a traced operation
+  inline const char * trace_operation_name(trace_operation operation_)
+  {
+    switch (operation_) {
+    case trace_operation::registered:    return "registered";
+    case trace_operation::unregistered:  return "unregistered";
+    case trace_operation::cleared:       return "cleared";
+    case trace_operation::import:        return "import";
+    case trace_operation::imported:      return "imported";
+    case trace_operation::kept:          return "kept";
+    case trace_operation::replaced:      return "replaced";
+    case trace_operation::plugin_loaded: return "plugin_loaded";
+    case trace_operation::created:       return "created";
+    case trace_operation::plugin_failed: return "plugin_failed";
+    }
+    return "unknown";
+  }
+
+  /*! \brief Binary record of a traced operation
+   *
+   *  An event is a fixed-size plain record: the ID and the label of the
+   *  register are copied, truncated if needed, so that the event does not
+   *  refer to the register. It fills two cache lines.
+   */
+  struct trace_event
+  {
+    static const std::size_t max_label_size = 16; ///< Number of stored characters of the label
+    static const std::size_t max_id_size = 90;    ///< Number of stored characters of the ID
+
+    std::uint64_t   timestamp_ns; ///< Time of the operation (ns, steady clock)
+    std::uint64_t   thread;       ///< Hash of the ID of the thread which performed the operation
+    std::uint32_t   id_size;      ///< Number of characters of the ID (before truncation)
+    trace_operation operation;    ///< Traced operation
+    std::uint8_t    label_size;   ///< Number of characters of the label (before truncation, saturated)
+    char            label[max_label_size]; ///< Label of the register (not null terminated)
+    char            id[max_id_size];       ///< ID (not null terminated)
+
+    /// Return the stored characters of the label of the register
+    id_view_type label_view() const
+    {
+      return id_view_type(label, label_size < max_label_size ? label_size : max_label_size);
+    }
+
+    /// Return the stored characters of the ID
+    id_view_type id_view() const
+    {
+      return id_view_type(id, id_size < max_id_size ? id_size : max_id_size);
+    }
+
+    /// Check if the label or the ID has been truncated
+    bool truncated() const
+    {
+      return label_size > max_label_size || id_size > max_id_size;
+    }
+
+  };
+
+  /// Print a trace event on a line
+  inline void print_trace_event(std::ostream & out_, const trace_event & event_)
+  {
+    out_ << "[trace] " << event_.timestamp_ns << " [" << std::hex << event_.thread << std::dec << "] "
+         << "'" << event_.label_view() << (event_.label_size > trace_event::max_label_size ? "...'" : "'") << ": "
+         << trace_operation_name(event_.operation)
+         << " '" << event_.id_view() << (event_.id_size > trace_event::max_id_size ? "...'" : "'") << '\n';
+    return;
+  }
+
+  /*! \brief Bounded lock-free ring buffer of trace events
+   *
+   *  Any number of threads may record events and drain the buffer
+   *  concurrently: each cell carries a sequence number which tells
+   *  producers and consumers whose turn it is, so that no operation locks.
+   *  Recording an event never blocks nor allocates: if the buffer is full,
+   *  the event is dropped and counted.
+   */
+  class trace_buffer
+  {
+  public:
+
+    typedef std::chrono::steady_clock clock_type;
+
+    static const std::size_t default_capacity = 4096;
+
+    /// Constructor with a capacity (rounded up to a power of 2)
+    explicit trace_buffer(std::size_t capacity_ = default_capacity)
+    {
+      std::size_t capacity = 2;
+      while (capacity < capacity_) capacity *= 2;
+      _cells_.reset(new cell_type[capacity]);
+      for (std::size_t i = 0; i < capacity; i++) {
+        _cells_[i].sequence.store(i, std::memory_order_relaxed);
+      }
+      _mask_ = capacity - 1;
+      return;
+    }
+
+    /// Not copyable
+    trace_buffer(const trace_buffer &) = delete;
+
+    /// Not assignable
+    trace_buffer & operator=(const trace_buffer &) = delete;
+
+    /// Return the number of events the buffer can hold
+    std::size_t capacity() const
+    {
+      return _mask_ + 1;
+    }
+
+    /// Return the number of events dropped because the buffer was full
+    std::uint64_t dropped() const
+    {
+      return _dropped_.load(std::memory_order_relaxed);
+    }
+
+    /// Record an operation, return false if the buffer is full and the event is dropped
+    bool record(trace_operation operation_, const id_view_type & label_, const id_view_type & id_)
+    {
+      std::size_t position = _tail_.load(std::memory_order_relaxed);
+      cell_type * cell = nullptr;
+      while (true) {
+        cell = &_cells_[position & _mask_];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(sequence - position);
+        if (lag == 0) {
+          if (_tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        } else if (lag < 0) {
+          // The oldest event has not been drained yet:
+          _dropped_.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        } else {
+          position = _tail_.load(std::memory_order_relaxed);
+        }
+      }
+      trace_event & event = cell->event;
+      event.timestamp_ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count());
+      event.thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+      event.operation = operation_;
+      event.id_size = static_cast<std::uint32_t>(id_.size());
+      event.label_size = static_cast<std::uint8_t>(label_.size() < 255 ? label_.size() : 255);
+      std::memcpy(event.label, label_.data(), label_.size() < trace_event::max_label_size ? label_.size() : trace_event::max_label_size);
+      std::memcpy(event.id, id_.data(), id_.size() < trace_event::max_id_size ? id_.size() : trace_event::max_id_size);
+      // Publish the event to the consumers:
+      cell->sequence.store(position + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// Remove the oldest event, return false if the buffer is empty
+    bool pop(trace_event & event_)
+    {
+      std::size_t position = _head_.load(std::memory_order_relaxed);
+      cell_type * cell = nullptr;
+      while (true) {
+        cell = &_cells_[position & _mask_];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+        if (lag == 0) {
+          if (_head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        } else if (lag < 0) {
+          return false;
+        } else {
+          position = _head_.load(std::memory_order_relaxed);
+        }
+      }
+      event_ = cell->event;
+      // Hand the cell back to the producers, one lap later:
+      cell->sequence.store(position + _mask_ + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// Remove all recorded events and pass them to a sink, in order, return their number
+    template <class Sink>
+    std::size_t drain(Sink && sink_)
+    {
+      std::size_t count = 0;
+      trace_event event;
+      while (this->pop(event)) {
+        sink_(event);
+        count++;
+      }
+      return count;
+    }
+
+  private:
+
+    /// \brief Cell of the ring
+    struct cell_type
+    {
+      std::atomic<std::size_t> sequence; ///< Position for which the cell is ready
+      trace_event event;                 ///< Recorded event
+    };
+
+    std::unique_ptr<cell_type[]> _cells_; ///< Cells of the ring
+    std::size_t _mask_ = 0;               ///< Capacity - 1
+    char _pad0_[64];                      ///< Keep the producers and consumers positions on distinct cache lines
+    std::atomic<std::size_t> _tail_{0};   ///< Position of the next recorded event
+    char _pad1_[64];
+    std::atomic<std::size_t> _head_{0};   ///< Position of the next drained event
+    std::atomic<std::uint64_t> _dropped_{0}; ///< Number of dropped events
+
+  };
+
+  /*! \brief Sink which drains a trace buffer in the background
+   *
+   *  A worker thread periodically drains the buffer and either prints the
+   *  events on a stream, one write per drain, or passes them to a handler,
+   *  so that formatting and output are kept off the traced operations. The
+   *  buffer is drained a last time when the writer is destroyed.
+   */
+  class trace_writer
+  {
+  public:
+
+    typedef std::function<void(const trace_event &)> handler_type;
+
+    /// Constructor with an output stream
+    explicit trace_writer(const std::shared_ptr<trace_buffer> & buffer_,
+                          std::ostream & out_ = std::cerr,
+                          std::chrono::milliseconds period_ = std::chrono::milliseconds(10))
+      : trace_writer(buffer_, handler_type(), &out_, period_)
+    {
+      return;
+    }
+
+    /// Constructor with an event handler
+    trace_writer(const std::shared_ptr<trace_buffer> & buffer_,
+                 const handler_type & handler_,
+                 std::chrono::milliseconds period_ = std::chrono::milliseconds(10))
+      : trace_writer(buffer_, handler_, nullptr, period_)
+    {
+      return;
+    }
+
+    /// Not copyable
+    trace_writer(const trace_writer &) = delete;
+
+    /// Not assignable
+    trace_writer & operator=(const trace_writer &) = delete;
+
+    /// Destructor (drains the remaining events)
+    ~trace_writer()
+    {
+      {
+        std::lock_guard<std::mutex> lock(_mutex_);
+        _stop_ = true;
+      }
+      _wake_.notify_all();
+      _worker_.join();
+      return;
+    }
+
+    /// Drain the buffer now, from the calling thread
+    void flush()
+    {
+      std::lock_guard<std::mutex> lock(_drain_mutex_);
+      this->_drain_();
+      return;
+    }
+
+  private:
+
+    /// Constructor
+    trace_writer(const std::shared_ptr<trace_buffer> & buffer_,
+                 const handler_type & handler_,
+                 std::ostream * out_,
+                 std::chrono::milliseconds period_)
+      : _buffer_(buffer_)
+      , _handler_(handler_)
+      , _out_(out_)
+      , _period_(period_)
+    {
+      _worker_ = std::thread(&trace_writer::_work_, this);
+      return;
+    }
+
+    /// Pass the buffered events to the handler, or print them
+    void _drain_()
+    {
+      if (_out_ == nullptr) {
+        _buffer_->drain(_handler_);
+        return;
+      }
+      // Events are formatted apart, then written at once (std::cerr flushes each insertion):
+      _text_.str(std::string());
+      _buffer_->drain([this](const trace_event & event_) { print_trace_event(_text_, event_); });
+      const std::uint64_t dropped = _buffer_->dropped();
+      if (dropped != _reported_dropped_) {
+        _text_ << "[trace] " << dropped - _reported_dropped_ << " events dropped\n";
+        _reported_dropped_ = dropped;
+      }
+      const std::string text = _text_.str();
+      if (text.empty()) return;
+      _out_->write(text.data(), static_cast<std::streamsize>(text.size()));
+      _out_->flush();
+      return;
+    }
+
+    /// Main loop of the worker
+    void _work_()
+    {
+      bool stop = false;
+      while (!stop) {
+        {
+          std::unique_lock<std::mutex> lock(_mutex_);
+          _wake_.wait_for(lock, _period_, [this]() { return _stop_; });
+          stop = _stop_;
+        }
+        // The last drain follows the stop request:
+        this->flush();
+      }
+      return;
+    }
+
+  private:
+
+    std::shared_ptr<trace_buffer> _buffer_;   ///< Drained buffer
+    handler_type              _handler_;      ///< Handler of the events
+    std::ostream *            _out_ = nullptr; ///< Output stream (null: events are passed to the handler)
+    std::ostringstream        _text_;         ///< Events formatted for the output stream
+    std::chrono::milliseconds _period_;       ///< Drain period
+    std::uint64_t             _reported_dropped_ = 0; ///< Number of dropped events already reported
+    std::mutex                _mutex_;        ///< Mutex of the stop flag
+    std::mutex                _drain_mutex_;  ///< Mutex serializing the drains
+    std::condition_variable   _wake_;         ///< Wake up of the worker
+    bool                      _stop_ = false; ///< Stop flag of the worker
+    std::thread               _worker_;       ///< Worker thread
+
+  };
+
+  namespace detail {
+
+    /// Return the process-wide trace buffer used by registers created with the init_trace flag
+    ///
+    /// Its events are printed on std::cerr in the background. It is large
+    /// enough to hold the bursts of registrations of a plugin library.
+    inline const std::shared_ptr<trace_buffer> & default_trace_buffer()
+    {
+      struct default_tracer_type
+      {
+        std::shared_ptr<trace_buffer> buffer = std::make_shared<trace_buffer>(32768);
+        trace_writer writer{buffer, std::cerr};
+      };
+      static default_tracer_type tracer;
+      return tracer.buffer;
+    }
+
+  } // end of namespace detail
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_FACTORY_TRACE_HPP
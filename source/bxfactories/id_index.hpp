@@ -0,0 +1,412 @@
+/// \file bxfactories/id_index.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_ID_INDEX_HPP
+#define BXFACTORIES_ID_INDEX_HPP
+
+// Standard Library:
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Third Party:
+// - Boost:
+#include <boost/utility/string_view.hpp>
+
+namespace bxfactories {
+
+  /*! \brief Non owning view on a registration ID
+   *
+   *  Implicitly constructible from a string literal, a null terminated C string
+   *  or any string-like object with data() and size() members (std::string,
+   *  boost::string_view and std::string_view when available), so lookups never
+   *  need to allocate.
+   */
+  class id_view
+    : public boost::string_view
+  {
+  public:
+
+    /// Default constructor (empty view)
+    id_view() = default;
+
+    /// Constructor from a null terminated C string
+    id_view(const char * id_)
+      : boost::string_view(id_)
+    {
+      return;
+    }
+
+    /// Constructor from a character range
+    id_view(const char * id_, std::size_t size_)
+      : boost::string_view(id_, size_)
+    {
+      return;
+    }
+
+    /// Constructor from a string-like object
+    template <class StringLike,
+              class = decltype(static_cast<const char *>(std::declval<const StringLike &>().data())),
+              class = decltype(static_cast<std::size_t>(std::declval<const StringLike &>().size()))>
+    id_view(const StringLike & id_)
+      : boost::string_view(id_.data(), id_.size())
+    {
+      return;
+    }
+
+  };
+
+  /// Type used to pass registration IDs to lookup methods
+  typedef id_view id_view_type;
+
+  namespace detail {
+
+    /// Return the little endian 64-bit word made of the bytes [first_, first_ + count_[ (count_ <= 8)
+    inline std::uint64_t load_id_word(const char * first_, std::size_t count_)
+    {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+      // Fixed size loads, possibly overlapping, avoid a call to memcpy:
+      if (count_ == 8) {
+        std::uint64_t w;
+        std::memcpy(&w, first_, 8);
+        return w;
+      }
+      if (count_ >= 4) {
+        std::uint32_t lo, hi;
+        std::memcpy(&lo, first_, 4);
+        std::memcpy(&hi, first_ + count_ - 4, 4);
+        return lo | (static_cast<std::uint64_t>(hi) << (8 * (count_ - 4)));
+      }
+      if (count_ == 0) return 0;
+      const std::uint64_t b0 = static_cast<unsigned char>(first_[0]);
+      const std::uint64_t b1 = static_cast<unsigned char>(first_[count_ / 2]);
+      const std::uint64_t b2 = static_cast<unsigned char>(first_[count_ - 1]);
+      return b0 | (b1 << (8 * (count_ / 2))) | (b2 << (8 * (count_ - 1)));
+#else
+      std::uint64_t w = 0;
+      for (std::size_t i = 0; i < count_; i++) {
+        w |= static_cast<std::uint64_t>(static_cast<unsigned char>(first_[i])) << (8 * i);
+      }
+      return w;
+#endif
+    }
+
+    /// Mix a 64-bit word into a running hash value
+    inline std::uint64_t mix_id_word(std::uint64_t h_, std::uint64_t w_)
+    {
+      h_ = (h_ ^ w_) * 0x9e3779b97f4a7c15ULL;
+      return h_ ^ (h_ >> 32);
+    }
+
+    /// Return the 64-bit hash of a registration ID
+    ///
+    /// IDs are consumed eight bytes at a time, which matters for long
+    /// namespaced IDs, then the result goes through a final avalanche step.
+    inline std::uint64_t hash_id(const id_view_type & id_)
+    {
+      const char * data = id_.data();
+      std::size_t count = id_.size();
+      std::uint64_t h = 0xcbf29ce484222325ULL ^ count;
+      for (; count >= 8; data += 8, count -= 8) {
+        h = mix_id_word(h, load_id_word(data, 8));
+      }
+      h = mix_id_word(h, load_id_word(data, count));
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      return h;
+    }
+
+    /// Return the little endian 64-bit word made of the bytes [first_ + i_, first_ + count_[ (constant expression)
+    constexpr std::uint64_t constant_load_id_word(const char * first_, std::size_t count_, std::size_t i_ = 0)
+    {
+      return i_ == count_ ? 0
+        : (static_cast<std::uint64_t>(static_cast<unsigned char>(first_[i_])) << (8 * i_)) | constant_load_id_word(first_, count_, i_ + 1);
+    }
+
+    /// Mix a 64-bit word into a running hash value (constant expression)
+    constexpr std::uint64_t constant_mix_id_word(std::uint64_t h_, std::uint64_t w_)
+    {
+      return ((h_ ^ w_) * 0x9e3779b97f4a7c15ULL) ^ (((h_ ^ w_) * 0x9e3779b97f4a7c15ULL) >> 32);
+    }
+
+    /// Mix the words of [data_, data_ + count_[ into a running hash value (constant expression)
+    constexpr std::uint64_t constant_mix_id_words(std::uint64_t h_, const char * data_, std::size_t count_)
+    {
+      return count_ >= 8
+        ? constant_mix_id_words(constant_mix_id_word(h_, constant_load_id_word(data_, 8)), data_ + 8, count_ - 8)
+        : constant_mix_id_word(h_, constant_load_id_word(data_, count_));
+    }
+
+    /// Final avalanche step of the hash of a registration ID (constant expression)
+    constexpr std::uint64_t constant_avalanche_id_hash(std::uint64_t h_, int step_ = 0)
+    {
+      return step_ == 0 ? constant_avalanche_id_hash(h_ ^ (h_ >> 33), 1)
+        : step_ == 1 ? constant_avalanche_id_hash(h_ * 0xff51afd7ed558ccdULL, 2)
+        : h_ ^ (h_ >> 33);
+    }
+
+    /// Return the 64-bit hash of a registration ID, equal to hash_id() (constant expression)
+    constexpr std::uint64_t constant_hash_id(const char * id_, std::size_t size_)
+    {
+      return constant_avalanche_id_hash(constant_mix_id_words(0xcbf29ce484222325ULL ^ size_, id_, size_));
+    }
+
+    /*! \brief Open addressing hash index from registration IDs to values
+     *
+     *  The index does not own the ID strings nor the values: each slot
+     *  stores the full hash, a view on the ID and a pointer to the value.
+     *  The owner must guarantee that both outlive their entry in the index.
+     *
+     *  Lookups may run concurrently with one modifying thread (the owner
+     *  serializes modifications): slots are filled before being published
+     *  with a release store of the value, and a slot which has been used
+     *  once keeps its key until the table is rebuilt, so an erased entry
+     *  leaves a tombstone behind. When the table grows or is purged from
+     *  its tombstones, a new table is published and the previous one is
+     *  retired but kept alive until reclaim() is called or the index is
+     *  destroyed, because some lookups may still be probing it.
+     */
+    template <class ValueType>
+    class id_index
+    {
+    public:
+
+      typedef ValueType value_type;
+
+      /// Default constructor
+      id_index() = default;
+
+      /// Not copyable
+      id_index(const id_index &) = delete;
+
+      /// Not assignable
+      id_index & operator=(const id_index &) = delete;
+
+      /// Return the number of indexed entries
+      std::size_t size() const
+      {
+        return _size_;
+      }
+
+      /// Return true if the index is empty
+      bool empty() const
+      {
+        return _size_ == 0;
+      }
+
+      /// Remove all entries
+      void clear()
+      {
+        if (_used_ == 0) return;
+        this->_publish_(min_capacity);
+        _size_ = 0;
+        _used_ = 0;
+        return;
+      }
+
+      /// Release the retired tables
+      ///
+      /// Must not run concurrently with any lookup.
+      void reclaim()
+      {
+        if (_tables_.size() < 2) return;
+        // The current table is always the last published one:
+        _tables_.erase(_tables_.begin(), _tables_.end() - 1);
+        return;
+      }
+
+      /// Make room for at least the given number of entries
+      void reserve(std::size_t count_)
+      {
+        if (2 * (_used_ + count_) > this->_capacity_()) this->_rehash_(_size_ + count_);
+        return;
+      }
+
+      /// Return the value associated to an ID, or null if it is not indexed
+      value_type * find(const id_view_type & id_) const
+      {
+        return find(id_, hash_id(id_));
+      }
+
+      /// Return the value associated to an ID with precomputed hash, or null if it is not indexed
+      value_type * find(const id_view_type & id_, std::uint64_t hash_) const
+      {
+        const table_type * table = _table_.load(std::memory_order_acquire);
+        if (table == nullptr) return nullptr;
+        const std::size_t mask = table->capacity - 1;
+        for (std::size_t pos = table->home(hash_); ; pos = (pos + 1) & mask) {
+          const slot_type & slot = table->slots[pos];
+          value_type * value = slot.value.load(std::memory_order_acquire);
+          if (value == nullptr) {
+            // Empty slot (end of the probe sequence) or tombstone:
+            if (slot.key_data.load(std::memory_order_acquire) == nullptr) return nullptr;
+            continue;
+          }
+          if (slot.hash == hash_ && slot.key_size == id_.size()
+              && std::char_traits<char>::compare(slot.key_data.load(std::memory_order_relaxed), id_.data(), id_.size()) == 0) {
+            return value;
+          }
+        }
+      }
+
+      /// Index a value under an ID which must not be already indexed
+      void insert(const id_view_type & id_, value_type * value_)
+      {
+        this->insert(id_, value_, hash_id(id_));
+        return;
+      }
+
+      /// Index a value under an ID with precomputed hash, which must not be already indexed
+      void insert(const id_view_type & id_, value_type * value_, std::uint64_t hash_)
+      {
+        if (2 * (_used_ + 1) > this->_capacity_()) this->_rehash_(_size_ + 1);
+        _table_.load(std::memory_order_relaxed)->place(hash_, id_, value_);
+        _size_++;
+        _used_++;
+        return;
+      }
+
+      /// Remove the entry associated to an ID, return false if it was not indexed
+      bool erase(const id_view_type & id_)
+      {
+        return this->erase(id_, hash_id(id_));
+      }
+
+      /// Remove the entry associated to an ID with precomputed hash, return false if it was not indexed
+      bool erase(const id_view_type & id_, std::uint64_t hash_)
+      {
+        table_type * table = _table_.load(std::memory_order_relaxed);
+        if (table == nullptr) return false;
+        const std::size_t mask = table->capacity - 1;
+        for (std::size_t pos = table->home(hash_); ; pos = (pos + 1) & mask) {
+          slot_type & slot = table->slots[pos];
+          const char * key_data = slot.key_data.load(std::memory_order_relaxed);
+          if (key_data == nullptr) return false;
+          if (slot.value.load(std::memory_order_relaxed) != nullptr
+              && slot.hash == hash_ && id_view_type(key_data, slot.key_size) == id_) {
+            // Leave a tombstone, the key stays in place for concurrent probes:
+            slot.value.store(nullptr, std::memory_order_release);
+            _size_--;
+            return true;
+          }
+        }
+      }
+
+    private:
+
+      /// \brief Slot of the table
+      ///
+      /// key_data is null for a slot which has never been used, value is
+      /// null for an empty slot and for a tombstone.
+      struct slot_type
+      {
+        std::uint64_t hash = 0;
+        std::size_t   key_size = 0;
+        std::atomic<const char *>  key_data{nullptr};
+        std::atomic<value_type *>  value{nullptr};
+      };
+
+      /// \brief Power of two sized array of slots
+      struct table_type
+      {
+        explicit table_type(std::size_t capacity_)
+          : slots(new slot_type[capacity_])
+          , capacity(capacity_)
+          , shift(64)
+        {
+          for (std::size_t c = capacity_; c > 1; c /= 2) shift--;
+          return;
+        }
+
+        std::size_t home(std::uint64_t hash_) const
+        {
+          // Fibonacci hashing spreads the hash bits over the whole table:
+          return static_cast<std::size_t>((hash_ * 0x9e3779b97f4a7c15ULL) >> shift);
+        }
+
+        void place(std::uint64_t hash_, const id_view_type & id_, value_type * value_)
+        {
+          const std::size_t mask = capacity - 1;
+          std::size_t pos = home(hash_);
+          while (slots[pos].key_data.load(std::memory_order_relaxed) != nullptr) pos = (pos + 1) & mask;
+          slot_type & slot = slots[pos];
+          slot.hash = hash_;
+          slot.key_size = id_.size();
+          // An empty ID still needs a non null key to mark the slot as used:
+          slot.key_data.store(id_.data() != nullptr ? id_.data() : "", std::memory_order_relaxed);
+          slot.value.store(value_, std::memory_order_release);
+          return;
+        }
+
+        std::unique_ptr<slot_type[]> slots;
+        std::size_t  capacity;
+        unsigned int shift;
+      };
+
+      static const std::size_t min_capacity = 16;
+
+      std::size_t _capacity_() const
+      {
+        const table_type * table = _table_.load(std::memory_order_relaxed);
+        return table == nullptr ? 0 : table->capacity;
+      }
+
+      /// Publish a new empty table
+      table_type * _publish_(std::size_t capacity_)
+      {
+        _tables_.emplace_back(new table_type(capacity_));
+        table_type * table = _tables_.back().get();
+        _table_.store(table, std::memory_order_release);
+        return table;
+      }
+
+      /// Publish a new table, large enough for the given number of entries, filled with the live entries
+      void _rehash_(std::size_t count_)
+      {
+        std::size_t capacity = min_capacity;
+        while (capacity < 2 * count_) capacity *= 2;
+        const table_type * old_table = _table_.load(std::memory_order_relaxed);
+        std::unique_ptr<table_type> table(new table_type(capacity));
+        if (old_table != nullptr) {
+          for (std::size_t pos = 0; pos < old_table->capacity; pos++) {
+            const slot_type & slot = old_table->slots[pos];
+            value_type * value = slot.value.load(std::memory_order_relaxed);
+            if (value == nullptr) continue;
+            table->place(slot.hash,
+                         id_view_type(slot.key_data.load(std::memory_order_relaxed), slot.key_size),
+                         value);
+          }
+        }
+        _tables_.push_back(std::move(table));
+        _table_.store(_tables_.back().get(), std::memory_order_release);
+        _used_ = _size_;
+        return;
+      }
+
+    private:
+
+      std::atomic<table_type *> _table_{nullptr}; ///< Current table
+      std::vector<std::unique_ptr<table_type> > _tables_; ///< Current and retired tables
+      std::size_t _size_ = 0; ///< Number of indexed entries
+      std::size_t _used_ = 0; ///< Number of used slots (indexed entries and tombstones)
+
+    };
+
+    template <class ValueType>
+    const std::size_t id_index<ValueType>::min_capacity;
+
+  } // end of namespace detail
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_ID_INDEX_HPP
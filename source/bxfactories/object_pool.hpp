@@ -0,0 +1,137 @@
+/// \file bxfactories/object_pool.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_OBJECT_POOL_HPP
+#define BXFACTORIES_OBJECT_POOL_HPP
+
+// Standard Library:
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace bxfactories {
+
+  namespace detail {
+
+    /*! \brief Free list allocator of fixed size storage
+     *
+     *  Storage slots of a given size and alignment are carved from blocks
+     *  of geometrically increasing sizes. Released slots are chained in an
+     *  intrusive free list and reused first, so that a stable population
+     *  of objects never reaches the global allocator. Blocks are only
+     *  released with the pool. The pool is not thread-safe.
+     */
+    class object_pool
+    {
+    public:
+
+      /// Constructor
+      object_pool(std::size_t size_, std::size_t alignment_)
+      {
+        if (alignment_ < alignof(free_slot_type)) alignment_ = alignof(free_slot_type);
+        if (size_ < sizeof(free_slot_type)) size_ = sizeof(free_slot_type);
+        _alignment_ = alignment_;
+        _slot_size_ = (size_ + alignment_ - 1) / alignment_ * alignment_;
+        return;
+      }
+
+      /// Not copyable
+      object_pool(const object_pool &) = delete;
+
+      /// Not assignable
+      object_pool & operator=(const object_pool &) = delete;
+
+      /// Destructor
+      ~object_pool()
+      {
+        for (void * block : _blocks_) {
+          ::operator delete(block);
+        }
+        return;
+      }
+
+      /// Return the size of a storage slot
+      std::size_t get_slot_size() const
+      {
+        return _slot_size_;
+      }
+
+      /// Return the total number of storage slots
+      std::size_t get_capacity() const
+      {
+        return _capacity_;
+      }
+
+      /// Return uninitialized storage for one object
+      void * allocate()
+      {
+        if (_free_ != nullptr) {
+          free_slot_type * slot = _free_;
+          _free_ = slot->next;
+          return slot;
+        }
+        if (_cursor_ == _end_) this->_grow_();
+        void * storage = _cursor_;
+        _cursor_ += _slot_size_;
+        return storage;
+      }
+
+      /// Give back storage obtained from allocate()
+      void deallocate(void * storage_)
+      {
+        free_slot_type * slot = ::new (storage_) free_slot_type;
+        slot->next = _free_;
+        _free_ = slot;
+        return;
+      }
+
+    private:
+
+      /// \brief Link of the free list, stored in released slots
+      struct free_slot_type
+      {
+        free_slot_type * next;
+      };
+
+      static const std::size_t first_block_slots = 16;
+      static const std::size_t max_block_slots = 4096;
+
+      /// Allocate a new block of slots
+      void _grow_()
+      {
+        const std::size_t nslots = _capacity_ == 0 ? first_block_slots
+          : (_capacity_ < max_block_slots ? _capacity_ : max_block_slots);
+        std::size_t bytes = nslots * _slot_size_ + _alignment_ - 1;
+        void * block = ::operator new(bytes);
+        _blocks_.push_back(block);
+        void * first = block;
+        std::align(_alignment_, nslots * _slot_size_, first, bytes);
+        _cursor_ = static_cast<char *>(first);
+        _end_ = _cursor_ + nslots * _slot_size_;
+        _capacity_ += nslots;
+        return;
+      }
+
+    private:
+
+      std::size_t      _slot_size_ = 0;    ///< Size of a slot (multiple of the alignment)
+      std::size_t      _alignment_ = 0;    ///< Alignment of the slots
+      std::size_t      _capacity_ = 0;     ///< Total number of slots
+      free_slot_type * _free_ = nullptr;   ///< Head of the free list
+      char *           _cursor_ = nullptr; ///< Next never used slot in the current block
+      char *           _end_ = nullptr;    ///< End of the current block
+      std::vector<void *> _blocks_;        ///< Allocated blocks
+
+    };
+
+  } // end of namespace detail
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_OBJECT_POOL_HPP
@@ -0,0 +1,247 @@
+/// \file bxfactories/perfect_hash_index.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_PERFECT_HASH_INDEX_HPP
+#define BXFACTORIES_PERFECT_HASH_INDEX_HPP
+
+// Standard Library:
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// This project:
+#include <bxfactories/id_index.hpp>
+
+namespace bxfactories {
+
+  namespace detail {
+
+    /*! \brief Immutable index from registration IDs to values, based on a minimal perfect hash
+     *
+     *  The index is built once from a fixed set of distinct IDs, with the
+     *  hash-and-displace method: IDs are dispatched in buckets of a few
+     *  IDs, then each bucket is given a pilot value, chosen so that the
+     *  IDs of all buckets land in distinct slots of a table which has
+     *  exactly one slot per ID. A lookup costs one hash of the ID, one
+     *  read of its bucket pilot and one comparison with the ID stored in
+     *  the selected slot. The IDs are copied in a contiguous arena.
+     *
+     *  The index never changes after construction, so lookups need no
+     *  synchronization. The values are not owned by the index.
+     */
+    template <class ValueType>
+    class perfect_hash_index
+    {
+    public:
+
+      typedef ValueType value_type;
+      typedef std::pair<id_view_type, value_type *> entry_type;
+
+      /// Build the index from distinct IDs
+      ///
+      /// The construction fails, and valid() returns false, in the
+      /// astronomically unlikely case two IDs have the same 64-bit hash,
+      /// or if no pilot value placing the IDs of a bucket in free slots
+      /// is found within max_attempts_ tries (0: automatic, a number of
+      /// tries which no realistic set of IDs ever exhausts).
+      explicit perfect_hash_index(const std::vector<entry_type> & entries_,
+                                  std::size_t max_attempts_ = 0)
+      {
+        this->_build_(entries_, max_attempts_);
+        return;
+      }
+
+      /// Not copyable (slots point into the ID arena)
+      perfect_hash_index(const perfect_hash_index &) = delete;
+
+      /// Not assignable
+      perfect_hash_index & operator=(const perfect_hash_index &) = delete;
+
+      /// Return true if the index could be built
+      bool valid() const
+      {
+        return _valid_;
+      }
+
+      /// Return the number of indexed entries
+      std::size_t size() const
+      {
+        return _size_;
+      }
+
+      /// Return the value associated to an ID, or null if it is not indexed
+      value_type * find(const id_view_type & id_) const
+      {
+        return find(id_, hash_id(id_));
+      }
+
+      /// Return the value associated to an ID with precomputed hash, or null if it is not indexed
+      value_type * find(const id_view_type & id_, std::uint64_t hash_) const
+      {
+        if (_size_ == 0) return nullptr;
+        const slot_type & slot = _slots_[this->_position_(hash_, _pilots_[this->_bucket_(hash_)])];
+        if (slot.hash != hash_ || slot.key_size != id_.size()) return nullptr;
+        if (std::char_traits<char>::compare(slot.key_data, id_.data(), id_.size()) != 0) return nullptr;
+        return slot.value;
+      }
+
+    private:
+
+      /// \brief Slot of the table
+      struct slot_type
+      {
+        std::uint64_t hash = 0;
+        std::size_t   key_size = 0;
+        const char *  key_data = nullptr;
+        value_type *  value = nullptr;
+      };
+
+      /// Average number of IDs per bucket
+      static const std::size_t bucket_load = 4;
+
+      static std::uint64_t _mix_(std::uint64_t x_)
+      {
+        x_ ^= x_ >> 31;
+        x_ *= 0x7fb5d329728ea185ULL;
+        x_ ^= x_ >> 27;
+        x_ *= 0x81dadef4bc2dd44dULL;
+        x_ ^= x_ >> 33;
+        return x_;
+      }
+
+      /// Map a 64-bit value to [0, n_[ without modulo
+      static std::size_t _reduce_(std::uint64_t x_, std::size_t n_)
+      {
+        // Multiply-shift on the high half of the value:
+        return static_cast<std::size_t>(((x_ >> 32) * static_cast<std::uint64_t>(n_)) >> 32);
+      }
+
+      std::size_t _bucket_(std::uint64_t hash_) const
+      {
+        return _reduce_(hash_, _buckets_);
+      }
+
+      std::size_t _position_(std::uint64_t hash_, std::uint64_t pilot_) const
+      {
+        // The pilot is stored premixed, the ID hash is already well mixed:
+        return _reduce_((hash_ ^ pilot_) * 0x9e3779b97f4a7c15ULL, _size_);
+      }
+
+      void _build_(const std::vector<entry_type> & entries_, std::size_t max_attempts_)
+      {
+        const std::size_t n = entries_.size();
+        _valid_ = true;
+        if (n == 0) return;
+        // The last buckets placed have a single ID and few free slots left,
+        // each pilot value then succeeds with a probability of about 1/n:
+        const std::uint64_t max_attempts = max_attempts_ != 0 ? max_attempts_ : 64 * static_cast<std::uint64_t>(n) + 1024;
+        std::vector<std::uint64_t> hashes(n);
+        for (std::size_t i = 0; i < n; i++) {
+          hashes[i] = hash_id(entries_[i].first);
+        }
+        {
+          std::vector<std::uint64_t> sorted_hashes(hashes);
+          std::sort(sorted_hashes.begin(), sorted_hashes.end());
+          if (std::adjacent_find(sorted_hashes.begin(), sorted_hashes.end()) != sorted_hashes.end()) {
+            _valid_ = false;
+            return;
+          }
+        }
+        _size_ = n;
+        _buckets_ = (n + bucket_load - 1) / bucket_load;
+        _slots_.resize(n);
+        _pilots_.assign(_buckets_, 0);
+        // Dispatch the entries in buckets, then place the largest buckets first:
+        std::vector<std::vector<std::size_t> > buckets(_pilots_.size());
+        for (std::size_t i = 0; i < n; i++) {
+          buckets[this->_bucket_(hashes[i])].push_back(i);
+        }
+        std::vector<std::size_t> order(buckets.size());
+        for (std::size_t b = 0; b < order.size(); b++) order[b] = b;
+        std::stable_sort(order.begin(), order.end(),
+                         [&buckets](std::size_t lhs_, std::size_t rhs_) {
+                           return buckets[lhs_].size() > buckets[rhs_].size();
+                         });
+        std::vector<bool> taken(n, false);
+        std::vector<std::size_t> positions;
+        for (std::size_t b : order) {
+          const std::vector<std::size_t> & bucket = buckets[b];
+          if (bucket.empty()) break;
+          bool placed = false;
+          for (std::uint64_t seed = 0; seed < max_attempts; seed++) {
+            const std::uint64_t pilot = _mix_(seed);
+            positions.clear();
+            bool ok = true;
+            for (std::size_t i : bucket) {
+              const std::size_t pos = this->_position_(hashes[i], pilot);
+              if (taken[pos] || std::find(positions.begin(), positions.end(), pos) != positions.end()) {
+                ok = false;
+                break;
+              }
+              positions.push_back(pos);
+            }
+            if (!ok) continue;
+            _pilots_[b] = pilot;
+            for (std::size_t k = 0; k < bucket.size(); k++) {
+              taken[positions[k]] = true;
+              slot_type & slot = _slots_[positions[k]];
+              slot.hash = hashes[bucket[k]];
+              slot.value = entries_[bucket[k]].second;
+            }
+            placed = true;
+            break;
+          }
+          if (!placed) {
+            _valid_ = false;
+            _size_ = 0;
+            _buckets_ = 0;
+            _pilots_.clear();
+            _slots_.clear();
+            return;
+          }
+        }
+        // Copy the IDs in the arena, in slot order:
+        std::vector<std::size_t> entry_of_slot(n);
+        for (std::size_t i = 0; i < n; i++) {
+          entry_of_slot[this->_position_(hashes[i], _pilots_[this->_bucket_(hashes[i])])] = i;
+        }
+        std::size_t arena_size = 0;
+        for (std::size_t i = 0; i < n; i++) arena_size += entries_[i].first.size();
+        _keys_.resize(arena_size);
+        std::size_t offset = 0;
+        for (std::size_t pos = 0; pos < n; pos++) {
+          const id_view_type & id = entries_[entry_of_slot[pos]].first;
+          _slots_[pos].key_size = id.size();
+          _slots_[pos].key_data = _keys_.data() + offset;
+          std::copy(id.data(), id.data() + id.size(), _keys_.begin() + offset);
+          offset += id.size();
+        }
+        return;
+      }
+
+    private:
+
+      bool _valid_ = false;                 ///< Construction status
+      std::size_t _size_ = 0;               ///< Number of indexed entries (and slots)
+      std::size_t _buckets_ = 0;            ///< Number of buckets
+      std::vector<std::uint64_t> _pilots_;  ///< Premixed pilot value of each bucket
+      std::vector<slot_type>     _slots_;   ///< One slot per ID
+      std::vector<char>          _keys_;    ///< Arena of the IDs
+
+    };
+
+    template <class ValueType>
+    const std::size_t perfect_hash_index<ValueType>::bucket_load;
+
+  } // end of namespace detail
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_PERFECT_HASH_INDEX_HPP
@@ -0,0 +1,275 @@
+/// \file bxfactories/plugin_manifest.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_PLUGIN_MANIFEST_HPP
+#define BXFACTORIES_PLUGIN_MANIFEST_HPP
+
+// Standard Library:
+#include <atomic>
+#include <fstream>
+#include <istream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Third Party:
+#if defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#define BXFACTORIES_HAS_DLOPEN 1
+#endif
+
+// This project:
+#include <bxfactories/id_index.hpp>
+
+namespace bxfactories {
+
+  /*! \brief Manifest of the plugin libraries which provide factories
+   *
+   *  A manifest maps registration IDs, or prefixes of registration IDs, to
+   *  the shared libraries whose auto-registered classes provide them. A
+   *  factory register associated to a manifest loads the library of an
+   *  unknown ID on demand, once, then retries the lookup. Only libraries
+   *  which are actually needed are so loaded.
+   *
+   *  Manifest files are made of lines with an ID (or a prefix ending with
+   *  '*') followed by the path of a library, relative paths being relative
+   *  to the directory of the manifest file. Empty lines and lines starting
+   *  with '#' are ignored:
+   *  \code
+   *  # Calorimeter models:
+   *  snemo::calo::optical_module   libcalo_plugin.so
+   *  snemo::tracker::*             /opt/plugins/libtracker_plugin.so
+   *  \endcode
+   *
+   *  A manifest is filled before being associated to registers. Loading
+   *  libraries is thread-safe. Unloading them runs the destructors of
+   *  their auto-registrators, which unregister their classes: no object
+   *  created by these classes may be alive, and the registers must not be
+   *  frozen.
+   */
+  class plugin_manifest
+  {
+  public:
+
+    /// Default constructor
+    plugin_manifest() = default;
+
+    /// Not copyable
+    plugin_manifest(const plugin_manifest &) = delete;
+
+    /// Not assignable
+    plugin_manifest & operator=(const plugin_manifest &) = delete;
+
+    /// Destructor (libraries are not unloaded)
+    ~plugin_manifest() = default;
+
+    /// Associate a library to a registration ID
+    void add(const std::string & id_, const std::string & library_)
+    {
+      library_type * library = this->_grab_library_(library_);
+      id_entry_type * entry = _ids_.find(id_);
+      if (entry == nullptr) {
+        _id_entries_.push_back(std::make_pair(id_, library));
+        entry = &_id_entries_.back();
+        // The index refers to the ID owned by the entry:
+        _ids_.insert(entry->first, entry);
+      }
+      entry->second = library;
+      return;
+    }
+
+    /// Associate a library to all registration IDs starting with a given prefix
+    void add_prefix(const std::string & prefix_, const std::string & library_)
+    {
+      library_type * library = this->_grab_library_(library_);
+      for (std::pair<std::string, library_type *> & entry : _prefixes_) {
+        if (entry.first == prefix_) {
+          entry.second = library;
+          return;
+        }
+      }
+      _prefixes_.push_back(std::make_pair(prefix_, library));
+      return;
+    }
+
+    /// Parse the entries of a manifest file
+    void load(const std::string & filename_)
+    {
+      std::ifstream fin(filename_);
+      if (!fin) {
+        std::ostringstream error_message;
+        error_message << "bxfactories::plugin_manifest::load(...): " << "Cannot open manifest file '" << filename_ << "' !";
+        throw std::runtime_error(error_message.str());
+      }
+      const std::string::size_type slash = filename_.find_last_of('/');
+      // A path without slash would be searched by the dynamic loader in its own directories:
+      const std::string directory = slash == std::string::npos ? std::string("./") : filename_.substr(0, slash + 1);
+      this->load(fin, directory);
+      return;
+    }
+
+    /// Parse manifest entries, relative library paths being relative to a given directory
+    void load(std::istream & in_, const std::string & directory_ = "")
+    {
+      std::string line;
+      std::size_t line_number = 0;
+      while (std::getline(in_, line)) {
+        line_number++;
+        std::istringstream line_in(line);
+        std::string id;
+        std::string library;
+        if (!(line_in >> id) || id[0] == '#') continue;
+        if (!(line_in >> library)) {
+          std::ostringstream error_message;
+          error_message << "bxfactories::plugin_manifest::load(...): " << "Missing library for ID '" << id << "' at line #" << line_number << " !";
+          throw std::logic_error(error_message.str());
+        }
+        if (library[0] != '/' && !directory_.empty()) library = directory_ + library;
+        if (id[id.size() - 1] == '*') {
+          this->add_prefix(id.substr(0, id.size() - 1), library);
+        } else {
+          this->add(id, library);
+        }
+      }
+      return;
+    }
+
+    /// Return the path of the library associated to a registration ID, or null
+    const std::string * find_library(const id_view_type & id_) const
+    {
+      const library_type * library = this->_find_(id_);
+      return library == nullptr ? nullptr : &library->path;
+    }
+
+    /// Load the library associated to a registration ID, if any and not done yet
+    ///
+    /// Return true if the library is loaded, so that a lookup may be retried.
+    /// A library which fails to load is not tried again: the failed_ flag,
+    /// if any, is set by the call which tried to load it, and the error is
+    /// then available from get_load_error().
+    bool load_for(const id_view_type & id_, bool * failed_ = nullptr)
+    {
+      library_type * library = this->_find_(id_);
+      if (library == nullptr) return false;
+      // Misses on IDs of an already loaded library do not lock:
+      if (library->handle.load(std::memory_order_acquire) != nullptr) return true;
+      std::lock_guard<std::mutex> lock(library->mutex);
+      if (library->handle.load(std::memory_order_relaxed) != nullptr) return true;
+      if (library->failed) return false;
+#ifdef BXFACTORIES_HAS_DLOPEN
+      // Static auto-registrators of the library run here:
+      void * handle = ::dlopen(library->path.c_str(), RTLD_NOW | RTLD_GLOBAL);
+      if (handle != nullptr) {
+        library->handle.store(handle, std::memory_order_release);
+        return true;
+      }
+      const char * error = ::dlerror();
+      library->error = error != nullptr ? error : "unknown error";
+#else
+      library->error = "plugin libraries are not supported on this platform";
+#endif // BXFACTORIES_HAS_DLOPEN
+      library->failed = true;
+      if (failed_ != nullptr) *failed_ = true;
+      return false;
+    }
+
+    /// Return the error of the library associated to a registration ID if it failed to load, or an empty string
+    std::string get_load_error(const id_view_type & id_) const
+    {
+      library_type * library = this->_find_(id_);
+      if (library == nullptr) return std::string();
+      std::lock_guard<std::mutex> lock(library->mutex);
+      if (!library->failed) return std::string();
+      return "Cannot load library '" + library->path + "': " + library->error;
+    }
+
+    /// Return true if the library associated to a registration ID is loaded
+    bool is_loaded(const id_view_type & id_) const
+    {
+      const library_type * library = this->_find_(id_);
+      return library != nullptr && library->handle.load(std::memory_order_acquire) != nullptr;
+    }
+
+    /// Unload all loaded libraries, in the reverse order of their declaration
+    void unload()
+    {
+      for (std::list<library_type>::reverse_iterator i = _libraries_.rbegin(); i != _libraries_.rend(); ++i) {
+        std::lock_guard<std::mutex> lock(i->mutex);
+        void * handle = i->handle.exchange(nullptr, std::memory_order_acq_rel);
+        if (handle == nullptr) continue;
+#ifdef BXFACTORIES_HAS_DLOPEN
+        // Static auto-registrators of the library unregister their classes here:
+        ::dlclose(handle);
+#endif // BXFACTORIES_HAS_DLOPEN
+      }
+      return;
+    }
+
+  private:
+
+    /// \brief A plugin library
+    struct library_type
+    {
+      explicit library_type(const std::string & path_)
+        : path(path_)
+      {
+        return;
+      }
+
+      std::string path;           ///< Path of the library
+      std::mutex  mutex;          ///< Mutex serializing the loading of the library
+      std::atomic<void *> handle{nullptr}; ///< Handle of the loaded library (null if not loaded)
+      bool        failed = false; ///< Flag set if the library failed to load
+      std::string error;          ///< Error reported by the dynamic loader
+    };
+
+    library_type * _grab_library_(const std::string & path_)
+    {
+      for (library_type & library : _libraries_) {
+        if (library.path == path_) return &library;
+      }
+      _libraries_.emplace_back(path_);
+      return &_libraries_.back();
+    }
+
+    library_type * _find_(const id_view_type & id_) const
+    {
+      const id_entry_type * entry = _ids_.find(id_);
+      if (entry != nullptr) return entry->second;
+      // The longest matching prefix wins:
+      library_type * library = nullptr;
+      std::size_t length = 0;
+      for (const std::pair<std::string, library_type *> & entry : _prefixes_) {
+        if (entry.first.size() >= length
+            && id_.size() >= entry.first.size()
+            && id_.compare(0, entry.first.size(), entry.first) == 0) {
+          library = entry.second;
+          length = entry.first.size();
+        }
+      }
+      return library;
+    }
+
+  private:
+
+    typedef std::pair<std::string, library_type *> id_entry_type;
+
+    std::list<library_type>     _libraries_;   ///< Plugin libraries (with stable addresses)
+    std::list<id_entry_type>    _id_entries_;  ///< Libraries by registration ID (with stable addresses)
+    detail::id_index<id_entry_type> _ids_;     ///< Hashed index of the libraries by registration ID
+    std::vector<std::pair<std::string, library_type *> > _prefixes_; ///< Libraries by ID prefix
+
+  };
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_PLUGIN_MANIFEST_HPP
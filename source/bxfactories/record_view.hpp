@@ -0,0 +1,245 @@
+/// \file bxfactories/record_view.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_RECORD_VIEW_HPP
+#define BXFACTORIES_RECORD_VIEW_HPP
+
+// Standard Library:
+#include <cstddef>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace bxfactories {
+
+  /*! \brief Range of records of a factory register, in ID order
+   *
+   *  Views are for expert use: the records of a register are normally
+   *  walked through a record_snapshot (records(), records_with_prefix(),
+   *  records_in_category()). A view refers to the records in place:
+   *  neither the records nor their IDs are copied. The register is locked
+   *  for the lifetime of the view (lock_records()...), so that it cannot be
+   *  modified while the records are walked, and views should be
+   *  short-lived. The thread which owns a view must not call any locking
+   *  member of the register, which would deadlock:
+   *  - (un)registration, clear(), reset(), compact(), freeze(), the import
+   *    into the register or from it, copy and assignment;
+   *  - print(), list_of_factory_ids(), list_of_categories() and another
+   *    view or snapshot (lock_records(), records()...);
+   *  - fetch_type_id() for a type whose type_info is not the registered
+   *    one (a class of the same name, from another shared library);
+   *  - any lookup of an unknown ID in a register with a plugin manifest,
+   *    which may load a library.
+   *
+   *  Lookups of registered IDs, object creation, size() and get_version()
+   *  never lock.
+   *
+   *  The underlying iterator refers either to an entry of the ordered
+   *  dictionary of the register, or to a pointer to a record.
+   */
+  template <class RecordType, class Iterator>
+  class record_view
+  {
+  public:
+
+    typedef RecordType record_type;
+
+    /// \brief Iterator on the records of a view
+    class iterator
+    {
+    public:
+
+      typedef std::forward_iterator_tag iterator_category;
+      typedef RecordType                value_type;
+      typedef std::ptrdiff_t            difference_type;
+      typedef const RecordType *        pointer;
+      typedef const RecordType &        reference;
+
+      iterator() = default;
+
+      explicit iterator(const Iterator & position_)
+        : _position_(position_)
+      {
+        return;
+      }
+
+      reference operator*() const
+      {
+        return _deref_(*_position_);
+      }
+
+      pointer operator->() const
+      {
+        return &_deref_(*_position_);
+      }
+
+      iterator & operator++()
+      {
+        ++_position_;
+        return *this;
+      }
+
+      iterator operator++(int)
+      {
+        iterator previous = *this;
+        ++_position_;
+        return previous;
+      }
+
+      bool operator==(const iterator & other_) const
+      {
+        return _position_ == other_._position_;
+      }
+
+      bool operator!=(const iterator & other_) const
+      {
+        return _position_ != other_._position_;
+      }
+
+    private:
+
+      /// Dereference a pointer to a record
+      static const RecordType & _deref_(const RecordType * record_)
+      {
+        return *record_;
+      }
+
+      /// Dereference an entry of a dictionary of records
+      template <class Key, class RecordIterator>
+      static const RecordType & _deref_(const std::pair<Key, RecordIterator> & entry_)
+      {
+        return *entry_.second;
+      }
+
+      Iterator _position_; ///< Position in the underlying container
+
+    };
+
+    typedef iterator const_iterator;
+
+    /// Constructor
+    record_view(std::unique_lock<std::mutex> && lock_, const Iterator & first_, const Iterator & last_)
+      : _lock_(std::move(lock_))
+      , _first_(first_)
+      , _last_(last_)
+    {
+      return;
+    }
+
+    /// Movable
+    record_view(record_view &&) = default;
+
+    /// Not copyable
+    record_view(const record_view &) = delete;
+
+    /// Not assignable
+    record_view & operator=(const record_view &) = delete;
+
+    /// Return an iterator on the first record
+    iterator begin() const
+    {
+      return iterator(_first_);
+    }
+
+    /// Return the past-the-end iterator
+    iterator end() const
+    {
+      return iterator(_last_);
+    }
+
+    /// Check if the view has no record
+    bool empty() const
+    {
+      return _first_ == _last_;
+    }
+
+    /// Return the number of records (linear in the number of records)
+    std::size_t size() const
+    {
+      return static_cast<std::size_t>(std::distance(_first_, _last_));
+    }
+
+  private:
+
+    std::unique_lock<std::mutex> _lock_; ///< Lock of the register
+    Iterator _first_; ///< Position of the first record
+    Iterator _last_;  ///< Past-the-end position
+
+  };
+
+  /*! \brief Records of a factory register, copied as pointers, in ID order
+   *
+   *  A snapshot copies the pointers to the records of a view, whose lock
+   *  is released before the snapshot is returned: the register may be
+   *  used freely, and modified, while a snapshot is walked, even from the
+   *  walking thread. Records of unregistered factories are kept alive by
+   *  the register, so that a snapshot remains valid, but may list
+   *  factories unregistered since it was taken, until the register is
+   *  compacted, assigned or destroyed.
+   */
+  template <class RecordType>
+  class record_snapshot
+  {
+  public:
+
+    typedef RecordType record_type;
+
+    /// \brief Pointers to the records
+    typedef std::vector<const RecordType *> record_pointers_type;
+
+    /// \brief Iterator on the records of a snapshot
+    typedef typename record_view<RecordType, typename record_pointers_type::const_iterator>::iterator iterator;
+
+    typedef iterator const_iterator;
+
+    /// Default constructor
+    record_snapshot() = default;
+
+    /// Constructor from a view
+    template <class Iterator>
+    explicit record_snapshot(const record_view<RecordType, Iterator> & view_)
+    {
+      for (const RecordType & record : view_) {
+        _records_.push_back(&record);
+      }
+      return;
+    }
+
+    /// Return an iterator on the first record
+    iterator begin() const
+    {
+      return iterator(_records_.begin());
+    }
+
+    /// Return the past-the-end iterator
+    iterator end() const
+    {
+      return iterator(_records_.end());
+    }
+
+    /// Check if the snapshot has no record
+    bool empty() const
+    {
+      return _records_.empty();
+    }
+
+    /// Return the number of records
+    std::size_t size() const
+    {
+      return _records_.size();
+    }
+
+  private:
+
+    record_pointers_type _records_; ///< Pointers to the records
+
+  };
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_RECORD_VIEW_HPP
@@ -0,0 +1,356 @@
+/// \file bxfactories/static_factory_register.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_STATIC_FACTORY_REGISTER_HPP
+#define BXFACTORIES_STATIC_FACTORY_REGISTER_HPP
+
+// Standard Library:
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+// This project:
+#include <bxfactories/factory.hpp>
+
+namespace bxfactories {
+
+  /*! \brief Base of the entries of a compile-time factory register
+   *
+   *  An entry associates a registration ID, returned by a static constexpr
+   *  id() method, to a class:
+   *  \code
+   *  struct foo_entry : bxfactories::static_factory_entry<foo>
+   *  {
+   *    static constexpr const char * id() { return "foo"; }
+   *  };
+   *  \endcode
+   *  or, equivalently:
+   *  \code
+   *  BXFACTORIES_STATIC_FACTORY_ENTRY(foo_entry, foo, "foo")
+   *  \endcode
+   */
+  template <class DerivedType>
+  struct static_factory_entry
+  {
+    typedef DerivedType type;
+  };
+
+  namespace detail {
+
+    /// Check if two null-terminated IDs are equal (constant expression)
+    constexpr bool static_id_equal(const char * lhs_, const char * rhs_)
+    {
+      return *lhs_ == *rhs_ && (*lhs_ == '\0' || static_id_equal(lhs_ + 1, rhs_ + 1));
+    }
+
+    /// Return the length of a null-terminated ID (constant expression)
+    constexpr std::size_t static_id_length(const char * id_, std::size_t length_ = 0)
+    {
+      return id_[length_] == '\0' ? length_ : static_id_length(id_, length_ + 1);
+    }
+
+    /// Key of an ID of a given length, made of its length and of its (up to) 8 last characters (constant expression)
+    ///
+    /// Namespaced IDs usually differ by their end, the key is so a cheap filter of the candidate IDs.
+    constexpr std::uint64_t static_id_key(const char * id_, std::size_t length_, std::size_t i_ = 0, std::uint64_t key_ = 0)
+    {
+      return (i_ == 8 || i_ == length_)
+        ? key_ ^ (static_cast<std::uint64_t>(length_) * 0x9E3779B97F4A7C15ULL)
+        : static_id_key(id_, length_, i_ + 1, key_ | (static_cast<std::uint64_t>(static_cast<unsigned char>(id_[length_ - 1 - i_])) << (8 * i_)));
+    }
+
+    /// Key of an ID, same as static_id_key()
+    inline std::uint64_t static_id_key(const id_view_type & id_)
+    {
+      const std::size_t length = id_.size();
+      const std::size_t ntail = length < 8 ? length : 8;
+      std::uint64_t key = 0;
+      for (std::size_t i = 0; i < ntail; i++) {
+        key |= static_cast<std::uint64_t>(static_cast<unsigned char>(id_[length - 1 - i])) << (8 * i);
+      }
+      return key ^ (static_cast<std::uint64_t>(length) * 0x9E3779B97F4A7C15ULL);
+    }
+
+    /// Index of an ID among the IDs of some entries, or the number of entries if not found (constant expression)
+    template <std::size_t Index>
+    constexpr std::size_t static_index_of(const char *)
+    {
+      return Index;
+    }
+
+    template <std::size_t Index, class Entry, class... Entries>
+    constexpr std::size_t static_index_of(const char * id_)
+    {
+      return static_id_equal(Entry::id(), id_) ? Index : static_index_of<Index + 1, Entries...>(id_);
+    }
+
+    /// Index of a class among the classes of some entries, or the number of entries if not found
+    template <std::size_t Index, class DerivedType>
+    constexpr std::size_t static_index_of_type()
+    {
+      return Index;
+    }
+
+    template <std::size_t Index, class DerivedType, class Entry, class... Entries>
+    constexpr std::size_t static_index_of_type()
+    {
+      return std::is_same<typename Entry::type, DerivedType>::value ? Index : static_index_of_type<Index + 1, DerivedType, Entries...>();
+    }
+
+    /// Check that the IDs of some entries are unique (constant expression)
+    template <std::size_t Index, class... AllEntries>
+    constexpr bool static_unique_ids()
+    {
+      return true;
+    }
+
+    template <std::size_t Index, class... AllEntries, class Entry, class... Entries>
+    constexpr bool static_unique_ids(Entry *, Entries *... entries_)
+    {
+      return static_index_of<0, AllEntries...>(Entry::id()) == Index
+        && static_unique_ids<Index + 1, AllEntries...>(entries_...);
+    }
+
+  } // end of namespace detail
+
+  /*! \brief Factory register of a closed set of classes known at compile time
+   *
+   *  The signature is either the base class, for default constructed
+   *  objects, or the signature of the creation from arguments:
+   *  \code
+   *  typedef bxfactories::static_factory_register<base, foo_entry, bar_entry> reg_type;
+   *  typedef bxfactories::static_factory_register<base * (const std::string &), foo_entry, bar_entry> reg_args_type;
+   *  \endcode
+   *
+   *  The table of the IDs and the dispatch table of the creation functions
+   *  are built at compile time: there is no registration at runtime and no
+   *  heap-allocated state. IDs are resolved to indexes in constant
+   *  expressions with index_of(), and objects are created by index through a
+   *  jump table, or by compile-time index with a direct call. Duplicated IDs
+   *  are rejected at compile time.
+   *
+   *  The lookup methods of factory_register (has, get, try_get, try_create,
+   *  list_of_factory_ids, fetch_type_id, size) are provided with the same
+   *  signatures, so that call sites templated on the register type work with
+   *  both. Runtime lookups compare precomputed keys of the IDs, which
+   *  suits small sets. The factories can also be exported to a runtime register.
+   */
+  template <class Signature, class... Entries>
+  class static_factory_register
+    : public static_factory_register<Signature * (), Entries...>
+  {
+  };
+
+  template <class BaseType, class... Args, class... Entries>
+  class static_factory_register<BaseType * (Args...), Entries...>
+  {
+  public:
+
+    static_assert(sizeof...(Entries) > 0,
+                  "bxfactories::static_factory_register<>: no entry!");
+    static_assert(detail::static_unique_ids<0, Entries...>(static_cast<Entries *>(nullptr)...),
+                  "bxfactories::static_factory_register<>: duplicated IDs!");
+
+    typedef BaseType                                       base_type;
+    typedef factory_register<BaseType, Args...>            register_type;
+    typedef typename register_type::factory_type           factory_type;
+    typedef base_type * (*creator_type)(Args &&... args_);
+
+    /// Index of the unknown IDs and classes
+    static constexpr std::size_t npos = sizeof...(Entries);
+
+    /// Return the number of registered factories
+    static constexpr std::size_t size()
+    {
+      return sizeof...(Entries);
+    }
+
+    /// Return the index of a registration ID, or npos (constant expression)
+    static constexpr std::size_t index_of(const char * id_)
+    {
+      return detail::static_index_of<0, Entries...>(id_);
+    }
+
+    /// Return the index of a registered class, or npos (constant expression)
+    template <class DerivedType>
+    static constexpr std::size_t index_of_type()
+    {
+      return detail::static_index_of_type<0, DerivedType, Entries...>();
+    }
+
+    /// Return the registration ID at a given index (constant expression)
+    static constexpr const char * id_at(std::size_t index_)
+    {
+      return _ids_[index_];
+    }
+
+    /// Return the index of a registration ID, or npos
+    static std::size_t find_index(const id_view_type & id_)
+    {
+      const std::uint64_t key = detail::static_id_key(id_);
+      for (std::size_t i = 0; i < sizeof...(Entries); i++) {
+        if (_keys_[i] == key && _lengths_[i] == id_.size()
+            && std::char_traits<char>::compare(_ids_[i], id_.data(), id_.size()) == 0) {
+          return i;
+        }
+      }
+      return npos;
+    }
+
+    /// Return true if a factory with given ID is registered
+    bool has(const id_view_type & id_) const
+    {
+      return find_index(id_) != npos;
+    }
+
+    /// Return the factory registered with given ID
+    const factory_type & get(const id_view_type & id_) const
+    {
+      const std::size_t index = find_index(id_);
+      if (index == npos) {
+        std::ostringstream error_message;
+        error_message << "bxfactory::static_factory_register<>::get(...): " << "Class ID '" << id_ << "' is not registered !";
+        throw std::logic_error(error_message.str());
+      }
+      return _factories_()[index];
+    }
+
+    /// Return the factory registered with given ID, or null
+    const factory_type * try_get(const id_view_type & id_) const
+    {
+      const std::size_t index = find_index(id_);
+      return index == npos ? nullptr : &_factories_()[index];
+    }
+
+    /// Create an object of the class registered with given ID, or return null
+    base_type * try_create(const id_view_type & id_, Args... args_) const
+    {
+      const std::size_t index = find_index(id_);
+      if (index == npos) return nullptr;
+      return _creators_[index](std::forward<Args>(args_)...);
+    }
+
+    /// Create an object of the class registered at a given index
+    base_type * create(std::size_t index_, Args... args_) const
+    {
+      if (index_ >= sizeof...(Entries)) {
+        std::ostringstream error_message;
+        error_message << "bxfactory::static_factory_register<>::create(...): " << "Invalid index [" << index_ << "] !";
+        throw std::logic_error(error_message.str());
+      }
+      return _creators_[index_](std::forward<Args>(args_)...);
+    }
+
+    /// Create an object of the class registered at an index known at compile time (direct call)
+    template <std::size_t Index>
+    static base_type * create(Args... args_)
+    {
+      static_assert(Index < sizeof...(Entries),
+                    "bxfactories::static_factory_register<>::create: invalid index!");
+      typedef typename std::tuple_element<Index, std::tuple<typename Entries::type...> >::type derived_type;
+      return new derived_type(std::forward<Args>(args_)...);
+    }
+
+    /// Copy the registration IDs into supplied container
+    void list_of_factory_ids(std::set<std::string> & ids_, bool clear_ = false) const
+    {
+      if (clear_) ids_.clear();
+      for (std::size_t i = 0; i < sizeof...(Entries); i++) {
+        ids_.insert(std::string(_ids_[i], _lengths_[i]));
+      }
+      return;
+    }
+
+    /// Fetch the registration ID of a given class
+    template <class DerivedType>
+    bool fetch_type_id(std::string & id_) const
+    {
+      const std::size_t index = index_of_type<DerivedType>();
+      if (index == npos) return false;
+      id_.assign(_ids_[index], _lengths_[index]);
+      return true;
+    }
+
+    /// Register all factories in a runtime register
+    void export_factories(register_type & register_) const
+    {
+      this->_export_<Entries...>(register_);
+      return;
+    }
+
+  private:
+
+    template <class DerivedType>
+    static base_type * _create_(Args &&... args_)
+    {
+      return new DerivedType(std::forward<Args>(args_)...);
+    }
+
+    template <class Entry, class... Rest>
+    typename std::enable_if<sizeof...(Rest) == 0>::type _export_(register_type & register_) const
+    {
+      register_.template register_factory<typename Entry::type>(Entry::id());
+      return;
+    }
+
+    template <class Entry, class... Rest>
+    typename std::enable_if<sizeof...(Rest) != 0>::type _export_(register_type & register_) const
+    {
+      register_.template register_factory<typename Entry::type>(Entry::id());
+      this->_export_<Rest...>(register_);
+      return;
+    }
+
+    /// Return the factory functions (built once, without allocation)
+    static const std::array<factory_type, sizeof...(Entries)> & _factories_()
+    {
+      static const std::array<factory_type, sizeof...(Entries)> factories = {{factory_type::template make<typename Entries::type>()...}};
+      return factories;
+    }
+
+    static constexpr const char *  _ids_[sizeof...(Entries)] = {Entries::id()...};                              ///< Registration IDs
+    static constexpr std::size_t   _lengths_[sizeof...(Entries)] = {detail::static_id_length(Entries::id())...}; ///< Lengths of the IDs
+    static constexpr std::uint64_t _keys_[sizeof...(Entries)] = {detail::static_id_key(Entries::id(), detail::static_id_length(Entries::id()))...}; ///< Keys of the IDs
+    static constexpr creator_type  _creators_[sizeof...(Entries)] = {&_create_<typename Entries::type>...};      ///< Dispatch table
+
+  };
+
+  template <class BaseType, class... Args, class... Entries>
+  constexpr std::size_t static_factory_register<BaseType * (Args...), Entries...>::npos;
+
+  template <class BaseType, class... Args, class... Entries>
+  constexpr const char * static_factory_register<BaseType * (Args...), Entries...>::_ids_[sizeof...(Entries)];
+
+  template <class BaseType, class... Args, class... Entries>
+  constexpr std::size_t static_factory_register<BaseType * (Args...), Entries...>::_lengths_[sizeof...(Entries)];
+
+  template <class BaseType, class... Args, class... Entries>
+  constexpr std::uint64_t static_factory_register<BaseType * (Args...), Entries...>::_keys_[sizeof...(Entries)];
+
+  template <class BaseType, class... Args, class... Entries>
+  constexpr typename static_factory_register<BaseType * (Args...), Entries...>::creator_type
+  static_factory_register<BaseType * (Args...), Entries...>::_creators_[sizeof...(Entries)];
+
+} // end of namespace bxfactories
+
+/// Declare an entry of a compile-time factory register
+#define BXFACTORIES_STATIC_FACTORY_ENTRY(EntryName, DerivedType, DerivedTypeId) \
+  struct EntryName : ::bxfactories::static_factory_entry< DerivedType > \
+  {                                                                     \
+    static constexpr const char * id() { return DerivedTypeId; }        \
+  };                                                                    \
+  /**/
+
+#endif // BXFACTORIES_STATIC_FACTORY_REGISTER_HPP
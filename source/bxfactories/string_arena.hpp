@@ -0,0 +1,124 @@
+/// \file bxfactories/string_arena.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_STRING_ARENA_HPP
+#define BXFACTORIES_STRING_ARENA_HPP
+
+// Standard Library:
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// This project:
+#include <bxfactories/id_index.hpp>
+
+namespace bxfactories {
+
+  namespace detail {
+
+    /*! \brief Append-only storage of strings, packed in chunks
+     *
+     *  Chunks grow geometrically, so that small registers stay small.
+     *  Interned strings are copied next to each other, null terminated, and
+     *  are never moved nor released before the arena is cleared or destroyed:
+     *  views on them can be published to concurrent readers. The owner
+     *  serializes the interning of strings.
+     */
+    class string_arena
+    {
+    public:
+
+      static const std::size_t first_chunk_size = 256;
+      static const std::size_t max_chunk_size = 65536;
+
+      /// Default constructor
+      string_arena() = default;
+
+      /// Not copyable
+      string_arena(const string_arena &) = delete;
+
+      /// Not assignable
+      string_arena & operator=(const string_arena &) = delete;
+
+      /// Copy a string in the arena and return a view on the copy
+      id_view_type intern(const id_view_type & string_)
+      {
+        // Empty strings need no storage:
+        if (string_.empty()) return id_view_type("", 0);
+        const std::size_t needed = string_.size() + 1;
+        if (needed > _free_) {
+          // The end of the current chunk is lost, strings longer than a chunk get their own:
+          const std::size_t size = needed > _chunk_size_ ? needed : _chunk_size_;
+          if (_chunk_size_ < max_chunk_size) _chunk_size_ *= 2;
+          _chunks_.emplace_back(new char[size]);
+          _next_ = _chunks_.back().get();
+          _free_ = size;
+          _capacity_ += size;
+        }
+        char * copy = _next_;
+        std::memcpy(copy, string_.data(), string_.size());
+        copy[string_.size()] = '\0';
+        _next_ += needed;
+        _free_ -= needed;
+        _used_ += needed;
+        return id_view_type(copy, string_.size());
+      }
+
+      /// Release all interned strings
+      void clear()
+      {
+        _chunks_.clear();
+        _next_ = nullptr;
+        _free_ = 0;
+        _used_ = 0;
+        _capacity_ = 0;
+        _chunk_size_ = first_chunk_size;
+        return;
+      }
+
+      /// Exchange the strings of two arenas (views on them remain valid)
+      void swap(string_arena & other_)
+      {
+        std::swap(_chunks_, other_._chunks_);
+        std::swap(_next_, other_._next_);
+        std::swap(_free_, other_._free_);
+        std::swap(_used_, other_._used_);
+        std::swap(_capacity_, other_._capacity_);
+        std::swap(_chunk_size_, other_._chunk_size_);
+        return;
+      }
+
+      /// Return the number of bytes used by the interned strings (terminators included)
+      std::size_t used() const
+      {
+        return _used_;
+      }
+
+      /// Return the number of allocated bytes
+      std::size_t capacity() const
+      {
+        return _capacity_;
+      }
+
+    private:
+
+      std::vector<std::unique_ptr<char[]> > _chunks_; ///< Allocated chunks
+      char *      _next_ = nullptr; ///< Next free byte of the current chunk
+      std::size_t _free_ = 0;       ///< Number of free bytes in the current chunk
+      std::size_t _used_ = 0;       ///< Number of used bytes
+      std::size_t _capacity_ = 0;   ///< Number of allocated bytes
+      std::size_t _chunk_size_ = first_chunk_size; ///< Size of the next chunk
+
+    };
+
+  } // end of namespace detail
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_STRING_ARENA_HPP
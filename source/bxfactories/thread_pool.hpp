@@ -0,0 +1,211 @@
+/// \file bxfactories/thread_pool.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_THREAD_POOL_HPP
+#define BXFACTORIES_THREAD_POOL_HPP
+
+// Standard Library:
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bxfactories {
+
+  /*! \brief Pool of worker threads with work stealing
+   *
+   *  The items of a parallel loop are dealt round-robin to the queues of
+   *  the workers. Each worker runs the items of its own queue, last dealt
+   *  first, then steals the oldest items of the other queues, so that a
+   *  few long items do not leave the other workers idle. The calling
+   *  thread takes part in the loop until all its items have run.
+   *
+   *  Several threads may run parallel loops on the same pool at the same
+   *  time. Tasks must not throw: they report their own errors.
+   */
+  class thread_pool
+  {
+  public:
+
+    /// Constructor with a number of worker threads (0: one per hardware thread, minus the calling one)
+    explicit thread_pool(unsigned int nworkers_ = 0)
+    {
+      if (nworkers_ == 0) {
+        const unsigned int ncores = std::thread::hardware_concurrency();
+        nworkers_ = ncores > 1 ? ncores - 1 : 1;
+      }
+      for (unsigned int w = 0; w < nworkers_; w++) {
+        _queues_.emplace_back(new queue_type);
+      }
+      for (unsigned int w = 0; w < nworkers_; w++) {
+        _workers_.emplace_back(&thread_pool::_work_, this, w);
+      }
+      return;
+    }
+
+    /// Not copyable
+    thread_pool(const thread_pool &) = delete;
+
+    /// Not assignable
+    thread_pool & operator=(const thread_pool &) = delete;
+
+    /// Destructor (waits for the workers, which run the remaining items first)
+    ~thread_pool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(_mutex_);
+        _stop_ = true;
+      }
+      _wake_.notify_all();
+      for (std::thread & worker : _workers_) worker.join();
+      return;
+    }
+
+    /// Return the number of worker threads
+    unsigned int size() const
+    {
+      return static_cast<unsigned int>(_workers_.size());
+    }
+
+    /// Run task_(i) for all i in [0, count_[, on the workers and on the calling thread
+    void parallel_for(std::size_t count_, const std::function<void(std::size_t)> & task_)
+    {
+      if (count_ == 0) return;
+      loop_type loop(task_, count_);
+      const std::size_t nqueues = _queues_.size();
+      for (std::size_t q = 0; q < nqueues; q++) {
+        queue_type & queue = *_queues_[q];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (std::size_t i = q; i < count_; i += nqueues) {
+          queue.items.push_back(item_type{&loop, i});
+        }
+      }
+      {
+        // The count of queued items is updated under the lock, so that no wake up is lost:
+        std::lock_guard<std::mutex> lock(_mutex_);
+        _queued_.fetch_add(count_, std::memory_order_release);
+      }
+      _wake_.notify_all();
+      // The calling thread helps until the items of its loop are all taken:
+      item_type item;
+      while (loop.remaining.load(std::memory_order_acquire) > 0 && this->_steal_(0, item)) {
+        this->_run_(item);
+      }
+      // The loop is only destroyed once the last worker has released its mutex:
+      std::unique_lock<std::mutex> lock(loop.mutex);
+      loop.done.wait(lock, [&loop]() { return loop.remaining.load(std::memory_order_acquire) == 0; });
+      return;
+    }
+
+  private:
+
+    /// \brief A parallel loop
+    struct loop_type
+    {
+      loop_type(const std::function<void(std::size_t)> & task_, std::size_t count_)
+        : task(task_)
+        , remaining(count_)
+      {
+        return;
+      }
+
+      const std::function<void(std::size_t)> & task; ///< Task of the items
+      std::atomic<std::size_t> remaining;            ///< Number of items not completed yet
+      std::mutex               mutex;                ///< Mutex of the completion
+      std::condition_variable  done;                 ///< Completion of all items
+    };
+
+    /// \brief An item of a parallel loop
+    struct item_type
+    {
+      loop_type * loop;
+      std::size_t index;
+    };
+
+    /// \brief Queue of the items dealt to a worker
+    struct queue_type
+    {
+      std::mutex              mutex;
+      std::deque<item_type>   items;
+    };
+
+    /// Take the last item of the own queue of a worker
+    bool _pop_(std::size_t worker_, item_type & item_)
+    {
+      queue_type & queue = *_queues_[worker_];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.items.empty()) return false;
+      item_ = queue.items.back();
+      queue.items.pop_back();
+      _queued_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+
+    /// Take the first item of the queue of another worker, starting after a given one
+    bool _steal_(std::size_t worker_, item_type & item_)
+    {
+      const std::size_t nqueues = _queues_.size();
+      for (std::size_t k = 1; k <= nqueues; k++) {
+        queue_type & queue = *_queues_[(worker_ + k) % nqueues];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.items.empty()) continue;
+        item_ = queue.items.front();
+        queue.items.pop_front();
+        _queued_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+      return false;
+    }
+
+    /// Run an item and signal the completion of its loop
+    void _run_(const item_type & item_)
+    {
+      loop_type & loop = *item_.loop;
+      loop.task(item_.index);
+      // The count is decremented under the mutex: the calling thread, which
+      // destroys the loop once the count is null, must wait for its release.
+      std::lock_guard<std::mutex> lock(loop.mutex);
+      if (loop.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        loop.done.notify_all();
+      }
+      return;
+    }
+
+    /// Main loop of a worker
+    void _work_(std::size_t worker_)
+    {
+      item_type item;
+      while (true) {
+        if (this->_pop_(worker_, item) || this->_steal_(worker_, item)) {
+          this->_run_(item);
+          continue;
+        }
+        std::unique_lock<std::mutex> lock(_mutex_);
+        _wake_.wait(lock, [this]() { return _stop_ || _queued_.load(std::memory_order_acquire) > 0; });
+        if (_stop_ && _queued_.load(std::memory_order_acquire) == 0) return;
+      }
+    }
+
+  private:
+
+    std::vector<std::unique_ptr<queue_type> > _queues_; ///< Queues of the workers
+    std::vector<std::thread> _workers_;   ///< Worker threads
+    std::mutex               _mutex_;     ///< Mutex of the wake ups
+    std::condition_variable  _wake_;      ///< Wake up of the idle workers
+    std::atomic<std::size_t> _queued_{0}; ///< Number of queued items
+    bool                     _stop_ = false; ///< Stop flag of the workers
+
+  };
+
+} // end of namespace bxfactories
+
+#endif // BXFACTORIES_THREAD_POOL_HPP
@@ -0,0 +1,62 @@
+/// \file testing/bxfactories_testing.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_TESTING_HPP
+#define BXFACTORIES_TESTING_HPP
+
+// Standard Library:
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+namespace bxfactories_testing {
+
+  /// Return the number of failed checks
+  inline std::atomic<int> & failures()
+  {
+    static std::atomic<int> _failures{0};
+    return _failures;
+  }
+
+  /// Report a failed check
+  inline void fail(const char * file_, int line_, const char * condition_)
+  {
+    failures().fetch_add(1);
+    std::cerr << file_ << ":" << line_ << ": check failed: " << condition_ << std::endl;
+    return;
+  }
+
+  /// Return the exit status of a test program
+  inline int status()
+  {
+    const int nfailures = failures().load();
+    if (nfailures != 0) {
+      std::cerr << nfailures << " check(s) failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  }
+
+} // end of namespace bxfactories_testing
+
+/// Check a condition, also in optimized builds (NDEBUG)
+#define BXFACTORIES_CHECK(Condition)                                     \
+  do {                                                                  \
+    if (!(Condition)) ::bxfactories_testing::fail(__FILE__, __LINE__, #Condition); \
+  } while (false)                                                       \
+  /**/
+
+/// Check that an expression throws an exception of a given type
+#define BXFACTORIES_CHECK_THROW(Expression, ExceptionType)              \
+  do {                                                                  \
+    bool _thrown = false;                                               \
+    try { Expression; } catch (ExceptionType &) { _thrown = true; }     \
+    if (!_thrown) ::bxfactories_testing::fail(__FILE__, __LINE__, #Expression " throws " #ExceptionType); \
+  } while (false)                                                       \
+  /**/
+
+#endif // BXFACTORIES_TESTING_HPP
@@ -0,0 +1,32 @@
+/// \file testing/plugin_shape.hpp
+/* Author(s)     : Francois Mauger <mauger@lpccaen.in2p3.fr>
+ * Creation date : 2026-10-17
+ * Last modified : 2026-10-17
+ *
+ */
+
+#ifndef BXFACTORIES_TESTING_PLUGIN_SHAPE_HPP
+#define BXFACTORIES_TESTING_PLUGIN_SHAPE_HPP
+
+// This project:
+#include <bxfactories/bxfactories.hpp>
+
+namespace testing {
+
+  /// A base interface whose derived classes are provided by a plugin library
+  class i_shape
+  {
+  public:
+
+    virtual ~i_shape() = default;
+
+    /// Return the number of corners of the shape
+    virtual int corners() const = 0;
+
+    BXFACTORIES_FACTORY_SYSTEM_REGISTER_INTERFACE(i_shape)
+
+  };
+
+} // end of namespace testing
+
+#endif // BXFACTORIES_TESTING_PLUGIN_SHAPE_HPP
@@ -0,0 +1,40 @@
+// Plugin library of the plugin test: it is not linked to the test program,
+// its classes are registered in the system register of the i_shape
+// interface when it is loaded through the manifest.
+
+// This project:
+#include "plugin_shape.hpp"
+
+namespace testing {
+
+  namespace shapes {
+
+    class square
+      : public i_shape
+    {
+    public:
+
+      int corners() const override { return 4; }
+
+      BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_INTERFACE(testing::i_shape, testing::shapes::square)
+
+    };
+
+    BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_IMPLEMENTATION(testing::i_shape, testing::shapes::square, "testing::shapes::square")
+
+    class triangle
+      : public i_shape
+    {
+    public:
+
+      int corners() const override { return 3; }
+
+      BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_INTERFACE(testing::i_shape, testing::shapes::triangle)
+
+    };
+
+    BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_IMPLEMENTATION(testing::i_shape, testing::shapes::triangle, "testing::shapes::triangle")
+
+  } // end of namespace shapes
+
+} // end of namespace testing
@@ -0,0 +1,136 @@
+// Deferred automatic registration of classes in a system register
+
+// Standard Library:
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+// This project:
+#include <bxfactories/factory_macros.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace testing {
+
+  class i_object
+  {
+  public:
+
+    virtual ~i_object() = default;
+
+    virtual int value() const = 0;
+
+    BXFACTORIES_FACTORY_SYSTEM_REGISTER_INTERFACE(i_object)
+
+  };
+
+  BXFACTORIES_FACTORY_SYSTEM_REGISTER_IMPLEMENTATION(i_object, "testing::i_object/system")
+
+  class alpha
+    : public i_object
+  {
+  public:
+
+    int value() const override { return 1; }
+
+    BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_INTERFACE(i_object, alpha)
+
+  };
+
+  BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_IMPLEMENTATION(i_object, alpha, "testing::alpha")
+
+  const std::string gamma_id("testing::gamma");
+
+  class gamma
+    : public i_object
+  {
+  public:
+
+    int value() const override { return 3; }
+
+    BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_INTERFACE(i_object, gamma)
+
+  };
+
+  // The ID is not a string literal:
+  BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_IMPLEMENTATION(i_object, gamma, gamma_id)
+
+  class beta
+    : public i_object
+  {
+  public:
+
+    int value() const override { return 2; }
+
+  };
+
+} // end of namespace testing
+
+namespace {
+
+  typedef bxfactories::_system_factory_registrator<testing::i_object, testing::beta> beta_registrator;
+
+  void test_static_registration()
+  {
+    const testing::i_object::factory_register_type & reg = testing::i_object::get_system_factory_register();
+    BXFACTORIES_CHECK(reg.has("testing::alpha"));
+    std::unique_ptr<testing::i_object> object(reg.try_create("testing::alpha"));
+    BXFACTORIES_CHECK(object && object->value() == 1);
+    BXFACTORIES_CHECK(testing::alpha::system_factory_auto_registration_id() == "testing::alpha");
+    std::unique_ptr<testing::i_object> other(reg.try_create("testing::gamma"));
+    BXFACTORIES_CHECK(other && other->value() == 3);
+    BXFACTORIES_CHECK(testing::gamma::system_factory_auto_registration_id() == "testing::gamma");
+    return;
+  }
+
+  void test_deferred_registration()
+  {
+    {
+      // Registered on the next access, unregistered on destruction:
+      beta_registrator registrator("testing::beta");
+      BXFACTORIES_CHECK(testing::i_object::get_system_factory_register().has("testing::beta"));
+    }
+    BXFACTORIES_CHECK(!testing::i_object::get_system_factory_register().has("testing::beta"));
+    {
+      // Unlinked while pending, never registered:
+      beta_registrator registrator("testing::beta");
+    }
+    BXFACTORIES_CHECK(!testing::i_object::get_system_factory_register().has("testing::beta"));
+    {
+      // IDs without static storage duration are copied:
+      std::unique_ptr<std::string> id(new std::string("testing::beta/copied"));
+      beta_registrator registrator(*id);
+      id.reset();
+      BXFACTORIES_CHECK(registrator.get_type_id() == "testing::beta/copied");
+      BXFACTORIES_CHECK(testing::i_object::get_system_factory_register().has("testing::beta/copied"));
+    }
+    BXFACTORIES_CHECK(!testing::i_object::get_system_factory_register().has("testing::beta/copied"));
+    return;
+  }
+
+  void test_rejected_registration()
+  {
+    {
+      beta_registrator duplicate("testing::alpha");
+      beta_registrator registrator("testing::beta");
+      BXFACTORIES_CHECK_THROW(testing::i_object::grab_system_factory_register(), std::logic_error);
+      // Registrations after the rejected one are performed anyway:
+      BXFACTORIES_CHECK(testing::i_object::get_system_factory_register().has("testing::beta"));
+    }
+    // The rejected registration does not remove the class registered under the same ID:
+    const testing::i_object::factory_register_type & reg = testing::i_object::get_system_factory_register();
+    BXFACTORIES_CHECK(reg.has("testing::alpha"));
+    std::unique_ptr<testing::i_object> object(reg.try_create("testing::alpha"));
+    BXFACTORIES_CHECK(object && object->value() == 1);
+    BXFACTORIES_CHECK(!reg.has("testing::beta"));
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_static_registration();
+  test_deferred_registration();
+  test_rejected_registration();
+  return bxfactories_testing::status();
+}
@@ -0,0 +1,113 @@
+// Batch creation of objects in contiguous storage
+
+// Standard Library:
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  std::atomic<int> alive{0};
+
+  struct base
+  {
+    base() { alive++; }
+    virtual ~base() { alive--; }
+    virtual int value() const = 0;
+  };
+
+  /// An over-aligned class, counting its constructions in a shared counter
+  struct alignas(32) item : public base
+  {
+    item(int & counter_, std::string tag_) : _value_(++counter_) { tag_ += "!"; }
+    int value() const override { return _value_; }
+    int _value_;
+  };
+
+  /// A class whose constructor fails after a few objects
+  struct fragile : public base
+  {
+    fragile(int & counter_, std::string)
+    {
+      if (++counter_ > 3) throw std::runtime_error("Cannot build more than 3 fragile objects");
+    }
+    int value() const override { return 0; }
+  };
+
+  typedef bxfactories::factory_register<base, int &, std::string> register_type;
+
+  void test_batch()
+  {
+    register_type reg("batch");
+    reg.register_factory<item>("testing::item");
+    int counter = 0;
+    const std::string tag("tag");
+    {
+      register_type::factory_batch_type batch = reg.create_batch("testing::item", 10, counter, tag);
+      BXFACTORIES_CHECK(batch.size() == 10 && batch.is_contiguous());
+      BXFACTORIES_CHECK(alive == 10);
+      // The lvalue reference is shared by all constructors, the string is copied for each of them:
+      BXFACTORIES_CHECK(counter == 10 && tag == "tag");
+      int good = 0;
+      for (std::size_t i = 0; i < batch.size(); i++) {
+        if (batch[i]->value() == static_cast<int>(i + 1)
+            && reinterpret_cast<std::uintptr_t>(batch[i]) % alignof(item) == 0) good++;
+      }
+      BXFACTORIES_CHECK(good == 10);
+      // The objects are stored one after the other:
+      BXFACTORIES_CHECK(reinterpret_cast<const char *>(batch[9]) - reinterpret_cast<const char *>(batch[0]) == 9 * static_cast<std::ptrdiff_t>(sizeof(item)));
+      register_type::factory_batch_type moved(std::move(batch));
+      BXFACTORIES_CHECK(batch.empty() && moved.size() == 10 && alive == 10);
+      reg.destroy_batch(moved);
+      BXFACTORIES_CHECK(moved.empty() && alive == 0);
+    }
+    register_type::factory_batch_type empty = reg.create_batch("testing::item", 0, counter, tag);
+    BXFACTORIES_CHECK(empty.empty() && !empty.is_contiguous());
+    return;
+  }
+
+  void test_errors()
+  {
+    register_type reg("batch");
+    reg.register_factory<fragile>("testing::fragile");
+    int counter = 0;
+    BXFACTORIES_CHECK_THROW(reg.create_batch("testing::unknown", 3, counter, "tag"), std::logic_error);
+    BXFACTORIES_CHECK_THROW(reg.create_batch(register_type::factory_handle_type(), 3, counter, "tag"), std::logic_error);
+    // The objects already constructed are destroyed when a constructor fails:
+    BXFACTORIES_CHECK_THROW(reg.create_batch("testing::fragile", 10, counter, "tag"), std::runtime_error);
+    BXFACTORIES_CHECK(counter == 4 && alive == 0);
+    return;
+  }
+
+  void test_unknown_layout()
+  {
+    register_type reg("batch");
+    // A class registered with a bare factory has no known layout: its objects are allocated one by one
+    reg.register_factory("testing::bare",
+                         register_type::factory_type([](int & counter_, std::string tag_) -> base * {
+                             return new item(counter_, tag_);
+                           }),
+                         typeid(item));
+    int counter = 0;
+    register_type::factory_batch_type batch = reg.create_batch("testing::bare", 5, counter, "tag");
+    BXFACTORIES_CHECK(batch.size() == 5 && !batch.is_contiguous() && alive == 5);
+    BXFACTORIES_CHECK(batch[4]->value() == 5);
+    batch.clear();
+    BXFACTORIES_CHECK(alive == 0);
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_batch();
+  test_errors();
+  test_unknown_layout();
+  return bxfactories_testing::status();
+}
@@ -0,0 +1,115 @@
+// Reclamation of the memory retained by a register under registration churn
+
+// Standard Library:
+#include <memory>
+#include <set>
+#include <string>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  struct base
+  {
+    virtual ~base() = default;
+    virtual int value() const = 0;
+  };
+
+  struct kept_object : public base
+  {
+    int value() const override { return 1; }
+  };
+
+  struct churn_object : public base
+  {
+    int value() const override { return 2; }
+  };
+
+  typedef bxfactories::factory_register<base> register_type;
+
+  /// Fill a register with kept factories, and (un)register others many times
+  void churn(register_type & reg_)
+  {
+    for (int i = 0; i < 32; i++) {
+      reg_.register_factory<kept_object>("kept::" + std::to_string(i), "A kept factory", i % 2 ? "odd" : "even");
+    }
+    for (int round = 0; round < 50; round++) {
+      for (int i = 0; i < 32; i++) {
+        reg_.register_factory<churn_object>("churn::" + std::to_string(i), "A churning factory", "churn");
+      }
+      for (int i = 0; i < 32; i++) {
+        reg_.unregister_factory("churn::" + std::to_string(i));
+      }
+    }
+    return;
+  }
+
+  /// Check the kept factories of a register
+  void check_kept(const register_type & reg_)
+  {
+    BXFACTORIES_CHECK(reg_.size() == 32);
+    for (int i = 0; i < 32; i++) {
+      const std::string id = "kept::" + std::to_string(i);
+      const register_type::factory_record_type * record = reg_.find(id);
+      BXFACTORIES_CHECK(record != nullptr);
+      if (record == nullptr) continue;
+      BXFACTORIES_CHECK(record->type_id == id);
+      BXFACTORIES_CHECK(record->description == "A kept factory");
+      BXFACTORIES_CHECK(record->category == (i % 2 ? "odd" : "even"));
+      std::unique_ptr<base> object(reg_.try_create(id));
+      BXFACTORIES_CHECK(object && object->value() == 1);
+    }
+    BXFACTORIES_CHECK(!reg_.has("churn::0"));
+    BXFACTORIES_CHECK(reg_.records_in_category("odd").size() == 16);
+    BXFACTORIES_CHECK(reg_.records_in_category("churn").empty());
+    std::set<std::string> categories;
+    reg_.list_of_categories(categories);
+    BXFACTORIES_CHECK(categories.size() == 2);
+    std::string id;
+    BXFACTORIES_CHECK(reg_.fetch_type_id<kept_object>(id) && id == "kept::0");
+    BXFACTORIES_CHECK(!reg_.fetch_type_id<churn_object>(id));
+    return;
+  }
+
+  void test_compact()
+  {
+    register_type reg("compact");
+    churn(reg);
+    const register_type::factory_handle_type handle = reg.resolve("kept::3");
+    const std::uint64_t version = reg.get_version();
+    reg.compact();
+    BXFACTORIES_CHECK(reg.get_version() > version);
+    check_kept(reg);
+    // Handles stay valid:
+    std::unique_ptr<base> object(reg.create(handle));
+    BXFACTORIES_CHECK(object && object->value() == 1);
+    // The register is still usable:
+    reg.register_factory<churn_object>("churn::0");
+    BXFACTORIES_CHECK(reg.has("churn::0"));
+    reg.unregister_factory("churn::0");
+    reg.compact();
+    check_kept(reg);
+    return;
+  }
+
+  void test_compact_frozen()
+  {
+    register_type reg("compact");
+    churn(reg);
+    reg.freeze();
+    reg.compact();
+    BXFACTORIES_CHECK(reg.is_frozen());
+    check_kept(reg);
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_compact();
+  test_compact_frozen();
+  return bxfactories_testing::status();
+}
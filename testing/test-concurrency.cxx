@@ -0,0 +1,132 @@
+// Lookups and object creation running concurrently with (un)registrations
+
+// Standard Library:
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  struct base
+  {
+    virtual ~base() = default;
+    virtual int value() const = 0;
+  };
+
+  struct stable_object : public base
+  {
+    int value() const override { return 1; }
+  };
+
+  struct churn_object : public base
+  {
+    int value() const override { return 2; }
+  };
+
+  typedef bxfactories::factory_register<base> register_type;
+
+  const int nstable = 64;
+  const int nchurn = 16;
+  const int nrounds = 200;
+  const int nreaders = 3;
+
+  std::string stable_id(int i_)
+  {
+    return "stable::" + std::to_string(i_);
+  }
+
+  std::string churn_id(int i_)
+  {
+    return "churn::" + std::to_string(i_);
+  }
+
+  /// Lookups of stable and churning IDs while a writer (un)registers the churning ones
+  void test_lookup_while_registering()
+  {
+    register_type reg("concurrency");
+    for (int i = 0; i < nstable; i++) {
+      reg.register_factory<stable_object>(stable_id(i));
+    }
+    std::vector<std::string> stable_ids;
+    std::vector<std::string> churn_ids;
+    for (int i = 0; i < nstable; i++) stable_ids.push_back(stable_id(i));
+    for (int i = 0; i < nchurn; i++) churn_ids.push_back(churn_id(i));
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> misses{0};
+    std::atomic<int> bad_values{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < nreaders; r++) {
+      readers.emplace_back([&, r]() {
+          std::size_t k = r;
+          while (!stop.load(std::memory_order_acquire)) {
+            const std::string & sid = stable_ids[k % stable_ids.size()];
+            const register_type::factory_record_type * record = reg.find(sid);
+            if (record == nullptr || record->type_id != sid) misses++;
+            std::unique_ptr<base> object(reg.try_create(sid));
+            if (!object || object->value() != 1) bad_values++;
+            // Churning IDs may be found or not, but never mixed up:
+            const std::string & cid = churn_ids[k % churn_ids.size()];
+            record = reg.find(cid);
+            if (record != nullptr && record->type_id != cid) bad_values++;
+            std::unique_ptr<base> churned(reg.try_create(cid));
+            if (churned && churned->value() != 2) bad_values++;
+            k++;
+          }
+          return;
+        });
+    }
+    for (int round = 0; round < nrounds; round++) {
+      for (int i = 0; i < nchurn; i++) reg.register_factory<churn_object>(churn_ids[i]);
+      for (int i = 0; i < nchurn; i++) reg.unregister_factory(churn_ids[i]);
+    }
+    stop.store(true, std::memory_order_release);
+    for (std::thread & reader : readers) reader.join();
+
+    BXFACTORIES_CHECK(misses.load() == 0);
+    BXFACTORIES_CHECK(bad_values.load() == 0);
+    BXFACTORIES_CHECK(reg.size() == static_cast<std::size_t>(nstable));
+    for (int i = 0; i < nchurn; i++) BXFACTORIES_CHECK(!reg.has(churn_ids[i]));
+    for (int i = 0; i < nstable; i++) BXFACTORIES_CHECK(reg.has(stable_ids[i]));
+    return;
+  }
+
+  /// Objects created concurrently by name and by handle
+  void test_concurrent_create()
+  {
+    register_type reg("concurrency");
+    for (int i = 0; i < nstable; i++) {
+      reg.register_factory<stable_object>(stable_id(i));
+    }
+    const register_type::factory_handle_type handle = reg.resolve(stable_id(0));
+    std::atomic<int> created{0};
+    std::vector<std::thread> creators;
+    for (int t = 0; t < nreaders + 1; t++) {
+      creators.emplace_back([&, t]() {
+          for (int i = 0; i < 2000; i++) {
+            std::unique_ptr<base> by_name(reg.get(stable_id((t + i) % nstable))());
+            std::unique_ptr<base> by_handle(reg.create(handle));
+            if (by_name->value() == 1 && by_handle->value() == 1) created++;
+          }
+          return;
+        });
+    }
+    for (std::thread & creator : creators) creator.join();
+    BXFACTORIES_CHECK(created.load() == (nreaders + 1) * 2000);
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_lookup_while_registering();
+  test_concurrent_create();
+  return bxfactories_testing::status();
+}
@@ -0,0 +1,88 @@
+// Concurrent creation of a set of objects on a thread pool
+
+// Standard Library:
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  struct base
+  {
+    explicit base(const std::string & name_) : name(name_) {}
+    virtual ~base() = default;
+    virtual int value() const = 0;
+    std::string name;
+  };
+
+  struct foo : public base
+  {
+    explicit foo(const std::string & name_) : base(name_) {}
+    int value() const override { return 1; }
+  };
+
+  struct bar : public base
+  {
+    explicit bar(const std::string & name_) : base(name_) {}
+    int value() const override { return 2; }
+  };
+
+  struct failing : public base
+  {
+    explicit failing(const std::string & name_) : base(name_) { throw std::runtime_error("Cannot build a failing object"); }
+    int value() const override { return 0; }
+  };
+
+  struct unexpected : public base
+  {
+    explicit unexpected(const std::string & name_) : base(name_) { throw 42; }
+    int value() const override { return 0; }
+  };
+
+  typedef bxfactories::factory_register<base, const std::string &> register_type;
+
+  void test_create_set()
+  {
+    register_type reg("set");
+    reg.register_factory<foo>("testing::foo");
+    reg.register_factory<bar>("testing::bar");
+    reg.register_factory<failing>("testing::failing");
+    reg.register_factory<unexpected>("testing::unexpected");
+    std::vector<std::string> ids;
+    for (int i = 0; i < 50; i++) {
+      ids.push_back(i % 2 ? "testing::bar" : "testing::foo");
+    }
+    ids.push_back("testing::unknown");
+    ids.push_back("testing::failing");
+    ids.push_back("testing::unexpected");
+    bxfactories::thread_pool pool(3);
+    const std::string name("shared");
+    std::vector<register_type::creation_result_type> results = reg.create_set(ids, pool, name);
+    BXFACTORIES_CHECK(results.size() == ids.size());
+    for (std::size_t i = 0; i < 50; i++) {
+      std::unique_ptr<base> object(results[i].object);
+      BXFACTORIES_CHECK(object && object->value() == (i % 2 ? 2 : 1) && object->name == "shared");
+      BXFACTORIES_CHECK(results[i].error.empty());
+    }
+    // Failures are reported with their item:
+    for (std::size_t i = 50; i < results.size(); i++) {
+      BXFACTORIES_CHECK(results[i].object == nullptr);
+      BXFACTORIES_CHECK(results[i].error.find(ids[i]) != std::string::npos || i == 51);
+    }
+    BXFACTORIES_CHECK(results[51].error == "Cannot build a failing object");
+    BXFACTORIES_CHECK(reg.create_set(std::vector<std::string>(), pool, name).empty());
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_create_set();
+  return bxfactories_testing::status();
+}
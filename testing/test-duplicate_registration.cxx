@@ -0,0 +1,115 @@
+// Duplicated IDs among the static auto-registrations of a system register
+
+// Standard Library:
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+// This project:
+#include <bxfactories/factory_macros.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace testing {
+
+  class i_item
+  {
+  public:
+
+    virtual ~i_item() = default;
+
+    virtual int value() const = 0;
+
+    BXFACTORIES_FACTORY_SYSTEM_REGISTER_INTERFACE(i_item);
+
+  };
+
+  BXFACTORIES_FACTORY_SYSTEM_REGISTER_IMPLEMENTATION(i_item, "testing::i_item/system")
+
+  class first : public i_item
+  {
+  public:
+    int value() const override { return 1; }
+    BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_INTERFACE(i_item, first)
+  };
+
+  BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_IMPLEMENTATION(i_item, first, "testing::first")
+
+  class second : public i_item
+  {
+  public:
+    int value() const override { return 2; }
+    BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_INTERFACE(i_item, second)
+  };
+
+  BXFACTORIES_FACTORY_SYSTEM_AUTO_REGISTRATION_IMPLEMENTATION(i_item, second, "testing::second")
+
+  class third : public i_item
+  {
+  public:
+    int value() const override { return 3; }
+  };
+
+  class fourth : public i_item
+  {
+  public:
+    int value() const override { return 4; }
+  };
+
+  class fifth : public i_item
+  {
+  public:
+    int value() const override { return 5; }
+  };
+
+  // Duplicates of the IDs above, registered during the static initialization too:
+  const bxfactories::_system_factory_registrator<i_item, third> third_registrator(BXFACTORIES_FACTORY_ID("testing::first"));
+  const bxfactories::_system_factory_registrator<i_item, fourth> fourth_registrator(std::string("testing::second"));
+  const bxfactories::_system_factory_registrator<i_item, fifth> fifth_registrator(BXFACTORIES_FACTORY_ID("testing::fifth"));
+
+} // end of namespace testing
+
+namespace {
+
+  void test_duplicates()
+  {
+    // Both duplicates are reported together, by the first access to the register:
+    std::string errors;
+    try {
+      testing::i_item::grab_system_factory_register();
+    } catch (std::logic_error & error_) {
+      errors = error_.what();
+    }
+    BXFACTORIES_CHECK(errors.find("'testing::first'") != std::string::npos);
+    BXFACTORIES_CHECK(errors.find("'testing::second'") != std::string::npos);
+    BXFACTORIES_CHECK(errors.find(" ; ") != std::string::npos);
+    // The errors are reported once, the first registration of each ID is kept:
+    const testing::i_item::factory_register_type & reg = testing::i_item::get_system_factory_register();
+    BXFACTORIES_CHECK(reg.size() == 3);
+    std::unique_ptr<testing::i_item> object(reg.try_create("testing::first"));
+    BXFACTORIES_CHECK(object && object->value() == 1);
+    object.reset(reg.try_create("testing::second"));
+    BXFACTORIES_CHECK(object && object->value() == 2);
+    object.reset(reg.try_create("testing::fifth"));
+    BXFACTORIES_CHECK(object && object->value() == 5);
+    return;
+  }
+
+  void test_type_ids()
+  {
+    BXFACTORIES_CHECK(testing::third_registrator.get_type_id() == "testing::first");
+    BXFACTORIES_CHECK(testing::fourth_registrator.get_type_id() == "testing::second");
+    // The raw ID of a factory ID is the literal itself:
+    BXFACTORIES_CHECK(std::string(testing::fifth_registrator.get_raw_type_id()) == "testing::fifth");
+    BXFACTORIES_CHECK(testing::fifth_registrator.get_type_id() == "testing::fifth");
+    BXFACTORIES_CHECK(&testing::fifth_registrator.get_type_id() == &testing::fifth_registrator.get_type_id());
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_duplicates();
+  test_type_ids();
+  return bxfactories_testing::status();
+}
@@ -0,0 +1,114 @@
+// Lightweight factory functions: empty, stateless and stateful targets
+
+// Standard Library:
+#include <functional>
+#include <memory>
+#include <string>
+
+// This project:
+#include <bxfactories/factory_function.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  struct base
+  {
+    virtual ~base() = default;
+    virtual int value() const = 0;
+  };
+
+  struct object : public base
+  {
+    explicit object(int value_ = 1) : _value_(value_) {}
+    int value() const override { return _value_; }
+    int _value_;
+  };
+
+  base * make_object()
+  {
+    return new object(2);
+  }
+
+  int alive_states = 0;
+
+  /// A function object carrying some state
+  struct stateful_maker
+  {
+    explicit stateful_maker(const std::string & tag_) : tag(tag_) { alive_states++; }
+    stateful_maker(const stateful_maker & other_) : tag(other_.tag) { alive_states++; }
+    ~stateful_maker() { alive_states--; }
+    base * operator()() const { return new object(static_cast<int>(tag.size())); }
+    std::string tag;
+  };
+
+  typedef bxfactories::factory_function<base> function_type;
+
+  int value_of(const function_type & f_)
+  {
+    std::unique_ptr<base> created(f_());
+    return created->value();
+  }
+
+  void test_empty()
+  {
+    function_type empty;
+    BXFACTORIES_CHECK(!empty && empty == nullptr && !empty.is_stateful());
+    BXFACTORIES_CHECK_THROW(empty(), std::bad_function_call);
+    base * (*null_pointer)() = nullptr;
+    function_type from_null(null_pointer);
+    BXFACTORIES_CHECK(!from_null);
+    return;
+  }
+
+  void test_stateless()
+  {
+    const function_type made = function_type::make<object>();
+    BXFACTORIES_CHECK(made && !made.is_stateful() && value_of(made) == 1);
+    const function_type from_pointer(&make_object);
+    BXFACTORIES_CHECK(from_pointer != nullptr && !from_pointer.is_stateful() && value_of(from_pointer) == 2);
+    const function_type from_lambda([]() -> base * { return new object(3); });
+    BXFACTORIES_CHECK(!from_lambda.is_stateful() && value_of(from_lambda) == 3);
+    return;
+  }
+
+  void test_stateful()
+  {
+    {
+      function_type f(stateful_maker("four"));
+      BXFACTORIES_CHECK(f.is_stateful() && value_of(f) == 4);
+      BXFACTORIES_CHECK(alive_states == 1);
+      // Copies share the heap block:
+      function_type copy(f);
+      function_type assigned;
+      assigned = copy;
+      BXFACTORIES_CHECK(alive_states == 1);
+      BXFACTORIES_CHECK(copy.is_stateful() && assigned.is_stateful() && value_of(assigned) == 4);
+      function_type moved(std::move(f));
+      BXFACTORIES_CHECK(!f && !f.is_stateful() && moved.is_stateful());
+      assigned = function_type::make<object>();
+      BXFACTORIES_CHECK(!assigned.is_stateful() && alive_states == 1);
+    }
+    // The block is released with the last copy:
+    BXFACTORIES_CHECK(alive_states == 0);
+    return;
+  }
+
+  void test_arguments()
+  {
+    typedef bxfactories::factory_function<base, int> function_args_type;
+    const function_args_type made = function_args_type::make<object>();
+    std::unique_ptr<base> created(made(7));
+    BXFACTORIES_CHECK(created->value() == 7);
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_empty();
+  test_stateless();
+  test_stateful();
+  test_arguments();
+  return bxfactories_testing::status();
+}
@@ -0,0 +1,72 @@
+// Registration IDs with a precomputed hash
+
+// Standard Library:
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include <bxfactories/factory_id.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  using namespace bxfactories::literals;
+
+  // The hash of a literal is a constant expression:
+  constexpr bxfactories::factory_id x_id = "x"_fid;
+  static_assert(x_id.size() == 1, "The size of a factory ID is the length of the literal");
+  static_assert(x_id.hash() == bxfactories::detail::constant_hash_id("x", 1),
+                "The hash of a factory ID is computed at compile time");
+  static_assert(std::integral_constant<std::uint64_t, "testing::object"_fid.hash()>::value
+                == BXFACTORIES_FACTORY_ID("testing::object").hash(),
+                "The literal and the macro compute the same hash");
+
+  struct base
+  {
+    virtual ~base() = default;
+  };
+
+  struct object : public base
+  {
+  };
+
+  typedef bxfactories::factory_register<base> register_type;
+
+  void test_hash()
+  {
+    // The compile-time hash is the one computed at run time by the register:
+    BXFACTORIES_CHECK("x"_fid.hash() == bxfactories::detail::hash_id(bxfactories::id_view_type("x")));
+    BXFACTORIES_CHECK(x_id.hash() == bxfactories::detail::hash_id(x_id.view()));
+    const std::string long_id(200, 'z');
+    const bxfactories::factory_id runtime_id(long_id.data(), long_id.size());
+    BXFACTORIES_CHECK(runtime_id.hash() == bxfactories::detail::hash_id(long_id));
+    BXFACTORIES_CHECK(""_fid.hash() == bxfactories::factory_id().hash());
+    BXFACTORIES_CHECK(""_fid.hash() == bxfactories::detail::hash_id(bxfactories::id_view_type()));
+    BXFACTORIES_CHECK("testing::object"_fid.view() == "testing::object");
+    return;
+  }
+
+  void test_lookup()
+  {
+    register_type reg("factory_id");
+    reg.register_factory<object>("testing::object");
+    constexpr bxfactories::factory_id object_id = "testing::object"_fid;
+    BXFACTORIES_CHECK(reg.has(object_id));
+    std::unique_ptr<base> created(reg.try_create(object_id));
+    BXFACTORIES_CHECK(created != nullptr);
+    BXFACTORIES_CHECK(reg.find(BXFACTORIES_FACTORY_ID("testing::object")) == reg.find("testing::object"));
+    BXFACTORIES_CHECK(reg.find("testing::other"_fid) == nullptr);
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_hash();
+  test_lookup();
+  return bxfactories_testing::status();
+}
@@ -0,0 +1,144 @@
+// Frozen registers: rejected modifications and perfect hash lookups
+
+// Standard Library:
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include <bxfactories/perfect_hash_index.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  struct base
+  {
+    virtual ~base() = default;
+    virtual int value() const = 0;
+  };
+
+  struct object : public base
+  {
+    int value() const override { return 1; }
+  };
+
+  typedef bxfactories::factory_register<base> register_type;
+
+  const int nids = 1000;
+
+  std::string id_of(int i_)
+  {
+    return "testing::object" + std::to_string(i_);
+  }
+
+  void fill(register_type & reg_)
+  {
+    for (int i = 0; i < nids; i++) {
+      reg_.register_factory<object>(id_of(i));
+    }
+    return;
+  }
+
+  /// Check the lookups of all registered IDs, and of unregistered ones
+  void check_lookups(const register_type & reg_)
+  {
+    int found = 0;
+    for (int i = 0; i < nids; i++) {
+      const register_type::factory_record_type * record = reg_.find(id_of(i));
+      if (record != nullptr && record->type_id == id_of(i)) found++;
+    }
+    BXFACTORIES_CHECK(found == nids);
+    int missed = 0;
+    for (int i = nids; i < 4 * nids; i++) {
+      if (!reg_.has(id_of(i))) missed++;
+    }
+    BXFACTORIES_CHECK(missed == 3 * nids);
+    BXFACTORIES_CHECK(!reg_.has(""));
+    BXFACTORIES_CHECK(!reg_.has("testing::object"));
+    BXFACTORIES_CHECK(!reg_.has("testing::object10000"));
+    BXFACTORIES_CHECK(reg_.try_create("testing::unknown") == nullptr);
+    std::unique_ptr<base> created(reg_.get(id_of(nids / 2))());
+    BXFACTORIES_CHECK(created && created->value() == 1);
+    return;
+  }
+
+  void test_rejections()
+  {
+    register_type source("source");
+    source.register_factory<object>("testing::imported");
+    register_type reg("frozen");
+    reg.register_factory<object>("testing::object");
+    BXFACTORIES_CHECK(!reg.is_frozen() && !reg.is_perfectly_indexed());
+    BXFACTORIES_CHECK(reg.freeze());
+    BXFACTORIES_CHECK(reg.is_frozen() && reg.is_perfectly_indexed());
+    BXFACTORIES_CHECK_THROW(reg.register_factory<object>("testing::other"), std::logic_error);
+    BXFACTORIES_CHECK_THROW(reg.unregister_factory("testing::object"), std::logic_error);
+    BXFACTORIES_CHECK_THROW(reg.clear(), std::logic_error);
+    BXFACTORIES_CHECK_THROW(reg.import(source), std::logic_error);
+    BXFACTORIES_CHECK(reg.size() == 1 && reg.has("testing::object") && !reg.has("testing::imported"));
+    // Freezing again changes nothing:
+    BXFACTORIES_CHECK(reg.freeze());
+    // A reset register is unfrozen:
+    reg.reset();
+    BXFACTORIES_CHECK(!reg.is_frozen() && !reg.is_perfectly_indexed());
+    reg.register_factory<object>("testing::other");
+    BXFACTORIES_CHECK(reg.has("testing::other"));
+    return;
+  }
+
+  void test_perfect_hash()
+  {
+    register_type reg("frozen");
+    fill(reg);
+    BXFACTORIES_CHECK(reg.freeze());
+    check_lookups(reg);
+    // An empty register can be frozen too:
+    register_type empty("empty");
+    BXFACTORIES_CHECK(empty.freeze());
+    BXFACTORIES_CHECK(!empty.has("testing::object0"));
+    // Copies of a frozen register are frozen:
+    register_type copy(reg);
+    BXFACTORIES_CHECK(copy.is_frozen() && copy.is_perfectly_indexed());
+    check_lookups(copy);
+    return;
+  }
+
+  void test_fallback()
+  {
+    // With a single pilot value per bucket, a thousand IDs cannot be placed:
+    std::vector<bxfactories::detail::perfect_hash_index<int>::entry_type> entries;
+    std::vector<std::string> ids;
+    for (int i = 0; i < nids; i++) ids.push_back(id_of(i));
+    int value = 0;
+    for (const std::string & id : ids) {
+      entries.push_back(std::make_pair(bxfactories::id_view_type(id), &value));
+    }
+    const bxfactories::detail::perfect_hash_index<int> failed(entries, 1);
+    BXFACTORIES_CHECK(!failed.valid() && failed.size() == 0);
+    BXFACTORIES_CHECK(failed.find(bxfactories::id_view_type(ids[0])) == nullptr);
+    const bxfactories::detail::perfect_hash_index<int> built(entries);
+    BXFACTORIES_CHECK(built.valid() && built.size() == entries.size());
+
+    // The register is frozen all the same, and keeps on using its hashed index:
+    register_type reg("fallback");
+    fill(reg);
+    BXFACTORIES_CHECK(!reg.freeze(1));
+    BXFACTORIES_CHECK(reg.is_frozen() && !reg.is_perfectly_indexed());
+    BXFACTORIES_CHECK(!reg.freeze());
+    BXFACTORIES_CHECK_THROW(reg.register_factory<object>("testing::other"), std::logic_error);
+    check_lookups(reg);
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_rejections();
+  test_perfect_hash();
+  test_fallback();
+  return bxfactories_testing::status();
+}
@@ -0,0 +1,130 @@
+// Pre-resolved factory handles: invalidation and reuse of slots
+
+// Standard Library:
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  struct base
+  {
+    virtual ~base() = default;
+    virtual int value() const = 0;
+  };
+
+  struct foo : public base
+  {
+    int value() const override { return 1; }
+  };
+
+  struct bar : public base
+  {
+    int value() const override { return 2; }
+  };
+
+  typedef bxfactories::factory_register<base> register_type;
+  typedef register_type::factory_handle_type handle_type;
+
+  void test_resolve()
+  {
+    register_type reg("handles");
+    reg.register_factory<foo>("testing::foo");
+    const handle_type handle = reg.resolve("testing::foo");
+    BXFACTORIES_CHECK(handle.generation != 0);
+    BXFACTORIES_CHECK(reg.has(handle));
+    BXFACTORIES_CHECK(reg.get_record(handle).type_id == "testing::foo");
+    std::unique_ptr<base> object(reg.create(handle));
+    BXFACTORIES_CHECK(object && object->value() == 1);
+    BXFACTORIES_CHECK_THROW(reg.resolve("testing::unknown"), std::logic_error);
+    // Default handles are null:
+    BXFACTORIES_CHECK(handle_type().generation == 0 && !reg.has(handle_type()));
+    BXFACTORIES_CHECK(reg.try_create(handle_type()) == nullptr);
+    // Other registrations do not invalidate the handle:
+    for (int i = 0; i < 100; i++) {
+      reg.register_factory<bar>("testing::bar" + std::to_string(i));
+    }
+    for (int i = 0; i < 100; i += 2) {
+      reg.unregister_factory("testing::bar" + std::to_string(i));
+    }
+    BXFACTORIES_CHECK(reg.has(handle));
+    BXFACTORIES_CHECK(reg.find(handle) == reg.find("testing::foo"));
+    return;
+  }
+
+  void test_invalidation()
+  {
+    register_type reg("handles");
+    reg.register_factory<foo>("testing::foo");
+    const handle_type handle = reg.resolve("testing::foo");
+    reg.unregister_factory("testing::foo");
+    BXFACTORIES_CHECK(!reg.has(handle));
+    BXFACTORIES_CHECK(reg.find(handle) == nullptr);
+    BXFACTORIES_CHECK(reg.try_get(handle) == nullptr);
+    BXFACTORIES_CHECK(reg.try_create(handle) == nullptr);
+    BXFACTORIES_CHECK_THROW(reg.get(handle), std::logic_error);
+    BXFACTORIES_CHECK_THROW(reg.create(handle), std::logic_error);
+    // Clearing the register invalidates all handles:
+    reg.register_factory<foo>("testing::foo");
+    reg.register_factory<bar>("testing::bar");
+    const handle_type foo_handle = reg.resolve("testing::foo");
+    const handle_type bar_handle = reg.resolve("testing::bar");
+    reg.clear();
+    BXFACTORIES_CHECK(!reg.has(foo_handle) && !reg.has(bar_handle));
+    return;
+  }
+
+  void test_generations()
+  {
+    register_type reg("handles");
+    reg.register_factory<foo>("testing::foo");
+    const handle_type old_handle = reg.resolve("testing::foo");
+    reg.unregister_factory("testing::foo");
+    // The slot is reused by the next registration, with a new generation:
+    reg.register_factory<bar>("testing::bar");
+    const handle_type new_handle = reg.resolve("testing::bar");
+    BXFACTORIES_CHECK(new_handle.slot == old_handle.slot);
+    BXFACTORIES_CHECK(new_handle.generation != old_handle.generation);
+    BXFACTORIES_CHECK(!reg.has(old_handle));
+    BXFACTORIES_CHECK(reg.try_create(old_handle) == nullptr);
+    std::unique_ptr<base> object(reg.create(new_handle));
+    BXFACTORIES_CHECK(object && object->value() == 2);
+    // Registering the same ID again does not revive old handles:
+    reg.unregister_factory("testing::bar");
+    reg.register_factory<bar>("testing::bar");
+    BXFACTORIES_CHECK(!reg.has(new_handle));
+    BXFACTORIES_CHECK(reg.has(reg.resolve("testing::bar")));
+    return;
+  }
+
+  void test_copies()
+  {
+    register_type reg("handles");
+    reg.register_factory<foo>("testing::foo");
+    reg.register_factory<bar>("testing::bar");
+    reg.unregister_factory("testing::foo");
+    const handle_type handle = reg.resolve("testing::bar");
+    // Copies of a register preserve handles:
+    register_type copy(reg);
+    BXFACTORIES_CHECK(copy.has(handle));
+    std::unique_ptr<base> object(copy.create(handle));
+    BXFACTORIES_CHECK(object && object->value() == 2);
+    copy.unregister_factory("testing::bar");
+    BXFACTORIES_CHECK(!copy.has(handle) && reg.has(handle));
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_resolve();
+  test_invalidation();
+  test_generations();
+  test_copies();
+  return bxfactories_testing::status();
+}
@@ -0,0 +1,134 @@
+// Bulk import of factories from another register
+
+// Standard Library:
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  struct base
+  {
+    virtual ~base() = default;
+    virtual int value() const = 0;
+  };
+
+  struct source_object : public base
+  {
+    int value() const override { return 1; }
+  };
+
+  struct target_object : public base
+  {
+    int value() const override { return 2; }
+  };
+
+  typedef bxfactories::factory_register<base> register_type;
+
+  /// Fill the source register
+  void fill_source(register_type & source_)
+  {
+    source_.register_factory<source_object>("shape::square", "A square", "shape");
+    source_.register_factory<source_object>("shape::disk", "A disk", "shape");
+    source_.register_factory<source_object>("color::red", "Red", "color");
+    source_.register_factory<source_object>("color::blue", "Blue", "color");
+    source_.register_factory<source_object>("common", "Common", "misc");
+    return;
+  }
+
+  /// Return the value of the objects created by a register for a given ID (0 if not registered)
+  int value_of(const register_type & reg_, const std::string & id_)
+  {
+    std::unique_ptr<base> object(reg_.try_create(id_));
+    return object ? object->value() : 0;
+  }
+
+  void test_import_all()
+  {
+    register_type target("target");
+    {
+      register_type source("source");
+      fill_source(source);
+      target.import(source);
+    }
+    // Imported records do not refer to the destroyed source register:
+    BXFACTORIES_CHECK(target.size() == 5);
+    const register_type::factory_record_type * record = target.find("shape::disk");
+    BXFACTORIES_CHECK(record != nullptr && record->description == "A disk" && record->category == "shape");
+    BXFACTORIES_CHECK(value_of(target, "color::red") == 1);
+    BXFACTORIES_CHECK(target.records_in_category("color").size() == 2);
+    return;
+  }
+
+  void test_import_selection()
+  {
+    register_type source("source");
+    fill_source(source);
+
+    register_type some("some");
+    std::set<std::string> selected;
+    selected.insert("shape::disk");
+    selected.insert("common");
+    selected.insert("unknown");
+    some.import_some(source, selected);
+    BXFACTORIES_CHECK(some.size() == 2);
+    BXFACTORIES_CHECK(some.has("shape::disk") && some.has("common"));
+
+    register_type prefixed("prefixed");
+    prefixed.import_prefix(source, "color::");
+    BXFACTORIES_CHECK(prefixed.size() == 2);
+    BXFACTORIES_CHECK(prefixed.has("color::red") && prefixed.has("color::blue"));
+
+    register_type categorized("categorized");
+    categorized.import_category(source, "shape");
+    categorized.import_category(source, "none");
+    BXFACTORIES_CHECK(categorized.size() == 2);
+    BXFACTORIES_CHECK(categorized.has("shape::square") && categorized.has("shape::disk"));
+    return;
+  }
+
+  void test_import_policies()
+  {
+    register_type source("source");
+    fill_source(source);
+
+    register_type target("target");
+    target.register_factory<target_object>("common");
+    target.register_factory<target_object>("shape::disk");
+
+    // Nothing is imported on conflicts:
+    BXFACTORIES_CHECK_THROW(target.import(source), std::logic_error);
+    BXFACTORIES_CHECK(target.size() == 2);
+    BXFACTORIES_CHECK(value_of(target, "common") == 2);
+
+    register_type skipping(target);
+    skipping.import(source, register_type::import_skip);
+    BXFACTORIES_CHECK(skipping.size() == 5);
+    BXFACTORIES_CHECK(value_of(skipping, "common") == 2);
+    BXFACTORIES_CHECK(value_of(skipping, "shape::disk") == 2);
+    BXFACTORIES_CHECK(value_of(skipping, "shape::square") == 1);
+
+    register_type overwriting(target);
+    overwriting.import(source, register_type::import_overwrite);
+    BXFACTORIES_CHECK(overwriting.size() == 5);
+    BXFACTORIES_CHECK(value_of(overwriting, "common") == 1);
+    BXFACTORIES_CHECK(value_of(overwriting, "shape::disk") == 1);
+    std::string id;
+    BXFACTORIES_CHECK(!overwriting.fetch_type_id<target_object>(id));
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_import_all();
+  test_import_selection();
+  test_import_policies();
+  return bxfactories_testing::status();
+}
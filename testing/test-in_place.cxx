@@ -0,0 +1,89 @@
+// Construction of objects in caller-supplied storage
+
+// Standard Library:
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  int alive = 0;
+
+  struct base
+  {
+    base() { alive++; }
+    virtual ~base() { alive--; }
+    virtual int value() const = 0;
+  };
+
+  /// An over-aligned class
+  struct alignas(64) wide : public base
+  {
+    explicit wide(int value_) : _value_(value_) {}
+    int value() const override { return _value_; }
+    int _value_;
+    char payload[100];
+  };
+
+  typedef bxfactories::factory_register<base, int> register_type;
+
+  void test_construct()
+  {
+    register_type reg("in_place");
+    reg.register_factory<wide>("testing::wide");
+    const register_type::factory_record_type & record = reg.get_record("testing::wide");
+    BXFACTORIES_CHECK(record.type_size == sizeof(wide) && record.type_alignment == alignof(wide));
+    std::aligned_storage<sizeof(wide), alignof(wide)>::type storage;
+    base * object = reg.construct_in_place("testing::wide", &storage, sizeof(storage), 7);
+    BXFACTORIES_CHECK(object != nullptr && object->value() == 7 && alive == 1);
+    BXFACTORIES_CHECK(static_cast<void *>(dynamic_cast<wide *>(object)) == static_cast<void *>(&storage));
+    reg.destroy_in_place(object);
+    BXFACTORIES_CHECK(alive == 0);
+    reg.destroy_in_place(nullptr);
+    // The storage can be reused:
+    object = reg.construct_in_place(reg.resolve("testing::wide"), &storage, sizeof(storage), 8);
+    BXFACTORIES_CHECK(object->value() == 8);
+    reg.destroy_in_place(object);
+    BXFACTORIES_CHECK(alive == 0);
+    return;
+  }
+
+  void test_errors()
+  {
+    register_type reg("in_place");
+    reg.register_factory<wide>("testing::wide");
+    reg.register_factory("testing::bare",
+                         register_type::factory_type([](int value_) -> base * { return new wide(value_); }),
+                         typeid(wide));
+    std::aligned_storage<2 * sizeof(wide), alignof(wide)>::type storage;
+    char * aligned = reinterpret_cast<char *>(&storage);
+    BXFACTORIES_CHECK_THROW(reg.construct_in_place("testing::unknown", aligned, sizeof(storage), 1), std::logic_error);
+    // The layout of a class registered with a bare factory is unknown:
+    BXFACTORIES_CHECK_THROW(reg.construct_in_place("testing::bare", aligned, sizeof(storage), 1), std::logic_error);
+    BXFACTORIES_CHECK_THROW(reg.construct_in_place("testing::wide", nullptr, sizeof(storage), 1), std::logic_error);
+    // Storage too small:
+    BXFACTORIES_CHECK_THROW(reg.construct_in_place("testing::wide", aligned, sizeof(wide) - 1, 1), std::logic_error);
+    // Storage not aligned:
+    BXFACTORIES_CHECK_THROW(reg.construct_in_place("testing::wide", aligned + 8, sizeof(storage) - 8, 1), std::logic_error);
+    BXFACTORIES_CHECK(alive == 0);
+    try {
+      reg.construct_in_place("testing::wide", aligned + 8, sizeof(storage) - 8, 1);
+    } catch (std::logic_error & error_) {
+      BXFACTORIES_CHECK(std::string(error_.what()).find("aligned on 64") != std::string::npos);
+    }
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_construct();
+  test_errors();
+  return bxfactories_testing::status();
+}
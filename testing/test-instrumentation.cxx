@@ -0,0 +1,134 @@
+// Creation statistics of an instrumented register (built with BXFACTORIES_WITH_INSTRUMENTATION)
+
+// Standard Library:
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include <bxfactories/factory_pool.hpp>
+#include "bxfactories_testing.hpp"
+
+#ifndef BXFACTORIES_WITH_INSTRUMENTATION
+#error "This test must be built with the BXFACTORIES_WITH_INSTRUMENTATION macro defined"
+#endif
+
+namespace {
+
+  struct base
+  {
+    virtual ~base() = default;
+    virtual int value() const = 0;
+  };
+
+  struct foo : public base
+  {
+    int value() const override { return 1; }
+  };
+
+  struct bar : public base
+  {
+    int value() const override { return 2; }
+  };
+
+  typedef bxfactories::factory_register<base> register_type;
+
+  /// Return the statistics of the factory registered under a given ID
+  bxfactories::factory_stats_snapshot stats_of(const register_type & reg_, const std::string & id_)
+  {
+    std::vector<bxfactories::factory_stats_snapshot> snapshots;
+    reg_.snapshot_stats(snapshots);
+    for (const bxfactories::factory_stats_snapshot & snapshot : snapshots) {
+      if (snapshot.type_id == id_) return snapshot;
+    }
+    return bxfactories::factory_stats_snapshot();
+  }
+
+  std::uint64_t histogram_total(const bxfactories::factory_stats_snapshot & snapshot_)
+  {
+    std::uint64_t total = 0;
+    for (std::uint64_t count : snapshot_.latency_histogram) total += count;
+    return total;
+  }
+
+  void test_counters()
+  {
+    BXFACTORIES_CHECK(register_type::is_instrumented());
+    register_type reg("instrumented");
+    reg.register_factory<foo>("testing::foo");
+    reg.register_factory<bar>("testing::bar");
+    // All creation paths are counted:
+    reg.destroy(reg.try_create("testing::foo"));
+    reg.destroy(reg.create(reg.resolve("testing::foo")));
+    reg.destroy(reg.get("testing::foo")());
+    // Objects deleted by the client code are not seen by the register:
+    delete reg.try_create("testing::foo");
+    {
+      register_type::factory_batch_type batch = reg.create_batch("testing::bar", 10);
+    }
+    std::aligned_storage<sizeof(bar), alignof(bar)>::type storage;
+    reg.destroy_in_place(reg.construct_in_place("testing::bar", &storage, sizeof(storage)));
+    // Misses are not counted:
+    BXFACTORIES_CHECK(reg.try_create("testing::unknown") == nullptr);
+    const bxfactories::factory_stats_snapshot foo_stats = stats_of(reg, "testing::foo");
+    BXFACTORIES_CHECK(foo_stats.type_id == "testing::foo");
+    BXFACTORIES_CHECK(foo_stats.created == 4 && foo_stats.destroyed == 3);
+    BXFACTORIES_CHECK(histogram_total(foo_stats) == 4);
+    BXFACTORIES_CHECK(foo_stats.mean_latency_ns() * 4 == static_cast<double>(foo_stats.total_latency_ns));
+    const bxfactories::factory_stats_snapshot bar_stats = stats_of(reg, "testing::bar");
+    BXFACTORIES_CHECK(bar_stats.created == 11 && bar_stats.destroyed == 11);
+    BXFACTORIES_CHECK(histogram_total(bar_stats) == 11);
+    std::ostringstream out;
+    reg.print_stats(out);
+    BXFACTORIES_CHECK(out.str().find("\"testing::foo\" created=4 destroyed=3") != std::string::npos);
+    return;
+  }
+
+  void test_pool()
+  {
+    register_type reg("instrumented");
+    reg.register_factory<foo>("testing::foo");
+    {
+      bxfactories::factory_pool<base> pool(reg);
+      for (int i = 0; i < 5; i++) {
+        bxfactories::factory_pool<base>::pointer_type object = pool.create("testing::foo");
+      }
+    }
+    const bxfactories::factory_stats_snapshot stats = stats_of(reg, "testing::foo");
+    BXFACTORIES_CHECK(stats.created == 5 && stats.destroyed == 5);
+    return;
+  }
+
+  void test_copies()
+  {
+    register_type reg("instrumented");
+    reg.register_factory<foo>("testing::foo");
+    reg.destroy(reg.try_create("testing::foo"));
+    // Copies of a register collect their own statistics:
+    register_type copy(reg);
+    BXFACTORIES_CHECK(stats_of(copy, "testing::foo").created == 0);
+    copy.destroy(copy.try_create("testing::foo"));
+    copy.destroy(copy.try_create("testing::foo"));
+    BXFACTORIES_CHECK(stats_of(copy, "testing::foo").created == 2);
+    BXFACTORIES_CHECK(stats_of(reg, "testing::foo").created == 1);
+    // Unregistered factories have no statistics anymore:
+    reg.unregister_factory("testing::foo");
+    std::vector<bxfactories::factory_stats_snapshot> snapshots;
+    reg.snapshot_stats(snapshots);
+    BXFACTORIES_CHECK(snapshots.empty());
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_counters();
+  test_pool();
+  test_copies();
+  return bxfactories_testing::status();
+}
@@ -0,0 +1,86 @@
+// Interning of the strings of the records of a register
+
+// Standard Library:
+#include <memory>
+#include <string>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  struct base
+  {
+    virtual ~base() = default;
+  };
+
+  struct object : public base
+  {
+  };
+
+  typedef bxfactories::factory_register<base> register_type;
+
+  void test_interning()
+  {
+    register_type reg("interning");
+    {
+      // The strings passed at registration are not referred to:
+      std::string id("testing::first");
+      std::string description("The first one");
+      std::string category("objects");
+      reg.register_factory<object>(id, description, category);
+      id = "testing::second";
+      reg.register_factory<object>(id, description, category);
+      id.assign(id.size(), 'x');
+      description.assign(description.size(), 'x');
+      category.assign(category.size(), 'x');
+    }
+    reg.register_factory<object>("testing::third", "", "others");
+    const register_type::factory_record_type * first = reg.find("testing::first");
+    const register_type::factory_record_type * second = reg.find("testing::second");
+    const register_type::factory_record_type * third = reg.find("testing::third");
+    BXFACTORIES_CHECK(first != nullptr && second != nullptr && third != nullptr);
+    if (first == nullptr || second == nullptr || third == nullptr) return;
+    BXFACTORIES_CHECK(first->type_id == "testing::first");
+    BXFACTORIES_CHECK(first->description == "The first one");
+    BXFACTORIES_CHECK(first->category == "objects");
+    // Each distinct category is stored once:
+    BXFACTORIES_CHECK(first->category.data() == second->category.data());
+    BXFACTORIES_CHECK(first->category.data() != third->category.data());
+    BXFACTORIES_CHECK(third->description.empty());
+    return;
+  }
+
+  void test_copies()
+  {
+    std::unique_ptr<register_type> source(new register_type("source"));
+    source->register_factory<object>("testing::first", "The first one", "objects");
+    register_type copy(*source);
+    register_type assigned("assigned");
+    assigned.register_factory<object>("testing::other");
+    assigned = *source;
+    source.reset();
+    // Copies intern their own strings:
+    for (const register_type * reg : {&copy, &assigned}) {
+      const register_type::factory_record_type * record = reg->find("testing::first");
+      BXFACTORIES_CHECK(record != nullptr);
+      if (record == nullptr) continue;
+      BXFACTORIES_CHECK(record->type_id == "testing::first");
+      BXFACTORIES_CHECK(record->description == "The first one");
+      BXFACTORIES_CHECK(record->category == "objects");
+      std::unique_ptr<base> created(reg->try_create("testing::first"));
+      BXFACTORIES_CHECK(created != nullptr);
+    }
+    BXFACTORIES_CHECK(!assigned.has("testing::other"));
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_interning();
+  test_copies();
+  return bxfactories_testing::status();
+}
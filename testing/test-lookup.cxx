@@ -0,0 +1,148 @@
+// Non-throwing lookups: find(), try_get() and try_create()
+
+// Standard Library:
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  /// Number of calls to the global allocator
+  std::atomic<long> allocations{0};
+
+}
+
+void * operator new(std::size_t size_)
+{
+  allocations++;
+  void * storage = std::malloc(size_ != 0 ? size_ : 1);
+  if (storage == nullptr) throw std::bad_alloc();
+  return storage;
+}
+
+void * operator new(std::size_t size_, const std::nothrow_t &) noexcept
+{
+  allocations++;
+  return std::malloc(size_ != 0 ? size_ : 1);
+}
+
+void operator delete(void * storage_) noexcept
+{
+  std::free(storage_);
+}
+
+void operator delete(void * storage_, std::size_t) noexcept
+{
+  std::free(storage_);
+}
+
+void operator delete(void * storage_, const std::nothrow_t &) noexcept
+{
+  std::free(storage_);
+}
+
+namespace {
+
+  struct base
+  {
+    virtual ~base() = default;
+    virtual int value() const = 0;
+  };
+
+  struct object : public base
+  {
+    explicit object(int value_) : _value_(value_) {}
+    int value() const override { return _value_; }
+    int _value_;
+  };
+
+  struct failing : public base
+  {
+    explicit failing(int) { throw std::runtime_error("Cannot build a failing object"); }
+    int value() const override { return 0; }
+  };
+
+  typedef bxfactories::factory_register<base, int> register_type;
+
+  void fill(register_type & reg_)
+  {
+    for (int i = 0; i < 100; i++) {
+      reg_.register_factory<object>("testing::object" + std::to_string(i));
+    }
+    reg_.register_factory<failing>("testing::failing");
+    return;
+  }
+
+  void test_hits()
+  {
+    register_type reg("lookup");
+    fill(reg);
+    const register_type::factory_record_type * record = reg.find("testing::object7");
+    BXFACTORIES_CHECK(record != nullptr && record->type_id == "testing::object7");
+    BXFACTORIES_CHECK(reg.try_get("testing::object7") == &record->fact);
+    std::unique_ptr<base> created(reg.try_create("testing::object7", 7));
+    BXFACTORIES_CHECK(created && created->value() == 7);
+    BXFACTORIES_CHECK(reg.find(bxfactories::factory_id("testing::object7")) == record);
+    // A failing constructor is not a miss:
+    BXFACTORIES_CHECK_THROW(reg.try_create("testing::failing", 0), std::runtime_error);
+    return;
+  }
+
+  void check_misses(const register_type & reg_, const std::string & id_)
+  {
+    const long before = allocations.load();
+    int missed = 0;
+    for (int i = 0; i < 10; i++) {
+      if (reg_.find(id_) == nullptr) missed++;
+      if (reg_.try_get(id_) == nullptr) missed++;
+      if (reg_.try_create(id_, i) == nullptr) missed++;
+      if (!reg_.has(id_)) missed++;
+    }
+    // A miss neither allocates nor throws:
+    BXFACTORIES_CHECK(missed == 40);
+    BXFACTORIES_CHECK(allocations.load() == before);
+    BXFACTORIES_CHECK_THROW(reg_.get(id_), std::logic_error);
+    BXFACTORIES_CHECK_THROW(reg_.get_record(id_), std::logic_error);
+    return;
+  }
+
+  void test_misses()
+  {
+    register_type reg("lookup");
+    const std::string unknown("testing::unknown");
+    const std::string empty;
+    const std::string prefix("testing::object");
+    const std::string longer("testing::object1000");
+    check_misses(reg, unknown);
+    fill(reg);
+    for (const std::string & id : {unknown, empty, prefix, longer}) {
+      check_misses(reg, id);
+    }
+    // Unregistered IDs are misses:
+    reg.unregister_factory("testing::object3");
+    check_misses(reg, "testing::object3");
+    BXFACTORIES_CHECK(reg.find(bxfactories::factory_id("testing::object3")) == nullptr);
+    BXFACTORIES_CHECK(reg.try_create(bxfactories::factory_id("testing::object3"), 3) == nullptr);
+    // Frozen registers too:
+    reg.freeze();
+    for (const std::string & id : {unknown, empty, prefix, longer}) {
+      check_misses(reg, id);
+    }
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_hits();
+  test_misses();
+  return bxfactories_testing::status();
+}
@@ -0,0 +1,159 @@
+// Restricted views of a register with local additions
+
+// Standard Library:
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+// This project:
+#include <bxfactories/factory_overlay.hpp>
+#include <bxfactories/factory_trace.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  struct base
+  {
+    virtual ~base() = default;
+    virtual int value() const = 0;
+  };
+
+  struct foo : public base
+  {
+    int value() const override { return 1; }
+  };
+
+  struct bar : public base
+  {
+    int value() const override { return 2; }
+  };
+
+  struct baz : public base
+  {
+    int value() const override { return 3; }
+  };
+
+  typedef bxfactories::factory_register<base>  register_type;
+  typedef bxfactories::factory_overlay<base>   overlay_type;
+
+  void fill(register_type & reg_)
+  {
+    reg_.register_factory<foo>("testing::foo");
+    reg_.register_factory<bar>("testing::bar");
+    return;
+  }
+
+  int created_value(const overlay_type & overlay_, const std::string & id_)
+  {
+    std::unique_ptr<base> object(overlay_.try_create(id_));
+    return object ? object->value() : 0;
+  }
+
+  void test_allow()
+  {
+    register_type reg("parent");
+    fill(reg);
+    overlay_type overlay(reg, "allow");
+    BXFACTORIES_CHECK(overlay.get_filter_mode() == overlay_type::filter_none);
+    BXFACTORIES_CHECK(overlay.has("testing::foo") && overlay.has("testing::bar"));
+    overlay.allow("testing::foo");
+    overlay.allow("testing::missing");
+    BXFACTORIES_CHECK(overlay.get_filter_mode() == overlay_type::filter_allow);
+    BXFACTORIES_CHECK(overlay.has("testing::foo") && !overlay.has("testing::bar"));
+    BXFACTORIES_CHECK(overlay.find("testing::foo") == reg.find("testing::foo"));
+    BXFACTORIES_CHECK(created_value(overlay, "testing::foo") == 1);
+    BXFACTORIES_CHECK(overlay.try_create("testing::bar") == nullptr);
+    BXFACTORIES_CHECK(overlay.try_get("testing::bar") == nullptr);
+    BXFACTORIES_CHECK_THROW(overlay.get("testing::bar"), std::logic_error);
+    // Allowed IDs unknown to the parent are not listed:
+    std::set<std::string> ids;
+    overlay.list_of_factory_ids(ids);
+    BXFACTORIES_CHECK(ids == std::set<std::string>({"testing::foo"}));
+    // An overlay either allows or denies:
+    BXFACTORIES_CHECK_THROW(overlay.deny("testing::bar"), std::logic_error);
+    return;
+  }
+
+  void test_deny()
+  {
+    register_type reg("parent");
+    fill(reg);
+    overlay_type overlay(reg, "deny");
+    overlay.deny("testing::foo");
+    BXFACTORIES_CHECK(overlay.get_filter_mode() == overlay_type::filter_deny);
+    BXFACTORIES_CHECK(!overlay.has("testing::foo") && overlay.has("testing::bar"));
+    BXFACTORIES_CHECK(overlay.try_create("testing::foo") == nullptr);
+    BXFACTORIES_CHECK(created_value(overlay, "testing::bar") == 2);
+    std::set<std::string> ids;
+    overlay.list_of_factory_ids(ids);
+    BXFACTORIES_CHECK(ids == std::set<std::string>({"testing::bar"}));
+    BXFACTORIES_CHECK_THROW(overlay.allow("testing::bar"), std::logic_error);
+    // Overlays are chained:
+    overlay_type child(overlay, "child");
+    child.deny("testing::bar");
+    BXFACTORIES_CHECK(!child.has("testing::foo") && !child.has("testing::bar"));
+    child.register_factory<foo>("testing::foo");
+    BXFACTORIES_CHECK(created_value(child, "testing::foo") == 1);
+    BXFACTORIES_CHECK(created_value(overlay, "testing::foo") == 0);
+    return;
+  }
+
+  void test_local()
+  {
+    register_type reg("parent");
+    fill(reg);
+    overlay_type overlay(reg, "local");
+    overlay.deny("testing::bar");
+    // Local factories hide those of the parent, and are not filtered:
+    overlay.register_factory<baz>("testing::foo");
+    overlay.register_factory<bar>("testing::bar");
+    overlay.register_factory<baz>("testing::baz");
+    BXFACTORIES_CHECK(created_value(overlay, "testing::foo") == 3);
+    BXFACTORIES_CHECK(created_value(overlay, "testing::bar") == 2);
+    BXFACTORIES_CHECK(created_value(overlay, "testing::baz") == 3);
+    BXFACTORIES_CHECK(overlay.find("testing::foo") != reg.find("testing::foo"));
+    // The parent is left unchanged:
+    BXFACTORIES_CHECK(!reg.has("testing::baz") && reg.size() == 2);
+    std::set<std::string> ids;
+    overlay.list_of_factory_ids(ids);
+    BXFACTORIES_CHECK(ids == std::set<std::string>({"testing::bar", "testing::baz", "testing::foo"}));
+    // Removing a local factory makes the one of the parent visible again:
+    overlay.unregister_factory("testing::foo");
+    BXFACTORIES_CHECK(created_value(overlay, "testing::foo") == 1);
+    overlay.unregister_factory("testing::bar");
+    BXFACTORIES_CHECK(!overlay.has("testing::bar"));
+    BXFACTORIES_CHECK_THROW(overlay.unregister_factory("testing::bar"), std::logic_error);
+    return;
+  }
+
+  void test_traced_creations()
+  {
+    using bxfactories::trace_operation;
+    std::shared_ptr<bxfactories::trace_buffer> buffer = std::make_shared<bxfactories::trace_buffer>(16);
+    register_type reg("parent");
+    fill(reg);
+    reg.set_tracer(buffer, true);
+    overlay_type overlay(reg, "traced");
+    overlay_type child(overlay, "child");
+    child.allow("testing::bar");
+    // The creations through an overlay are seen by the tracer of the parent:
+    std::unique_ptr<base> object(child.try_create("testing::bar"));
+    BXFACTORIES_CHECK(child.try_create("testing::foo") == nullptr);
+    bxfactories::trace_event event;
+    BXFACTORIES_CHECK(buffer->pop(event));
+    BXFACTORIES_CHECK(event.operation == trace_operation::created && event.id_view() == "testing::bar");
+    BXFACTORIES_CHECK(!buffer->pop(event));
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_allow();
+  test_deny();
+  test_local();
+  test_traced_creations();
+  return bxfactories_testing::status();
+}
@@ -0,0 +1,152 @@
+// Classes of a plugin library loaded on demand through a manifest, then unloaded
+
+// Standard Library:
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// This project:
+#include "plugin_shape.hpp"
+#include "bxfactories_testing.hpp"
+
+namespace testing {
+
+  // The system register is exported to the plugin library:
+  BXFACTORIES_FACTORY_SYSTEM_REGISTER_IMPLEMENTATION(testing::i_shape, "testing::i_shape/__system__")
+
+  /// A class registered under an ID of the plugin library
+  class local_square
+    : public i_shape
+  {
+  public:
+
+    int corners() const override { return 4; }
+
+  };
+
+} // end of namespace testing
+
+namespace {
+
+  typedef testing::i_shape::factory_register_type register_type;
+
+  /// Return the IDs registered in the system register
+  std::set<std::string> registered_ids()
+  {
+    std::set<std::string> ids;
+    testing::i_shape::get_system_factory_register().list_of_factory_ids(ids);
+    return ids;
+  }
+
+  /// Look up and create the classes of the plugin, which loads it
+  void check_loaded(register_type & reg_, const bxfactories::plugin_manifest & plugins_)
+  {
+    BXFACTORIES_CHECK(registered_ids().empty());
+    BXFACTORIES_CHECK(!plugins_.is_loaded("testing::shapes::square"));
+    BXFACTORIES_CHECK(reg_.find("testing::shapes::square") != nullptr);
+    BXFACTORIES_CHECK(plugins_.is_loaded("testing::shapes::square"));
+    BXFACTORIES_CHECK(registered_ids().size() == 2);
+    std::unique_ptr<testing::i_shape> square(reg_.try_create("testing::shapes::square"));
+    BXFACTORIES_CHECK(square && square->corners() == 4);
+    std::unique_ptr<testing::i_shape> triangle(reg_.try_create("testing::shapes::triangle"));
+    BXFACTORIES_CHECK(triangle && triangle->corners() == 3);
+    // Only the IDs of the manifest are looked up in the plugin:
+    BXFACTORIES_CHECK(reg_.try_create("testing::shapes::disk") == nullptr);
+    BXFACTORIES_CHECK(!reg_.has("testing::circle"));
+    return;
+  }
+
+  /// A lookup which fails while loading the plugin is reported by create_set()
+  void check_failed_lookup(register_type & reg_, bxfactories::plugin_manifest & plugins_)
+  {
+    {
+      bxfactories::_system_factory_registrator<testing::i_shape, testing::local_square> local("testing::shapes::square");
+      BXFACTORIES_CHECK(registered_ids().size() == 1);
+      // The registration of the square of the library is rejected, that of the triangle is performed:
+      bxfactories::thread_pool pool(2);
+      std::vector<std::string> ids(1, "testing::shapes::triangle");
+      std::vector<register_type::creation_result_type> results = reg_.create_set(ids, pool);
+      BXFACTORIES_CHECK(results.size() == 1 && results[0].object == nullptr);
+      BXFACTORIES_CHECK(results[0].error.find("testing::shapes::square") != std::string::npos);
+      BXFACTORIES_CHECK(reg_.has("testing::shapes::triangle"));
+      plugins_.unload();
+      // The rejected registrator of the library does not remove the local class:
+      BXFACTORIES_CHECK(registered_ids().size() == 1);
+      std::unique_ptr<testing::i_shape> square(reg_.try_create("testing::shapes::square"));
+      BXFACTORIES_CHECK(dynamic_cast<testing::local_square *>(square.get()) != nullptr);
+    }
+    BXFACTORIES_CHECK(registered_ids().empty());
+    return;
+  }
+
+  /// A library which cannot be loaded is reported once, through the trace buffer
+  void check_failed_library(register_type & reg_, bxfactories::plugin_manifest & plugins_)
+  {
+    std::shared_ptr<bxfactories::trace_buffer> buffer = std::make_shared<bxfactories::trace_buffer>(16);
+    reg_.set_tracer(buffer);
+    BXFACTORIES_CHECK(plugins_.get_load_error("testing::missing").empty());
+    BXFACTORIES_CHECK(!reg_.has("testing::missing"));
+    BXFACTORIES_CHECK(reg_.try_create("testing::missing") == nullptr);
+    reg_.set_tracer(nullptr);
+    bxfactories::trace_event event;
+    BXFACTORIES_CHECK(buffer->pop(event));
+    BXFACTORIES_CHECK(event.operation == bxfactories::trace_operation::plugin_failed && event.id_view() == "testing::missing");
+    BXFACTORIES_CHECK(!buffer->pop(event));
+    const std::string error = plugins_.get_load_error("testing::missing");
+    BXFACTORIES_CHECK(error.find("/nonexistent/libbxfactories-missing.so") != std::string::npos);
+    BXFACTORIES_CHECK(!plugins_.is_loaded("testing::missing"));
+    return;
+  }
+
+  /// Only system registers load plugin libraries
+  void check_rejected_manifest(const std::shared_ptr<bxfactories::plugin_manifest> & plugins_)
+  {
+    register_type reg("other");
+    BXFACTORIES_CHECK_THROW(reg.set_plugin_manifest(plugins_), std::logic_error);
+    reg.set_plugin_manifest(nullptr);
+    BXFACTORIES_CHECK(!reg.get_plugin_manifest());
+    // Copies of the system register are not system registers:
+    register_type copy(testing::i_shape::get_system_factory_register());
+    BXFACTORIES_CHECK(!copy.get_plugin_manifest());
+    BXFACTORIES_CHECK(!copy.has("testing::shapes::square"));
+    BXFACTORIES_CHECK(!plugins_->is_loaded("testing::shapes::square"));
+    return;
+  }
+
+  /// Lookups on a frozen register do not load libraries
+  void check_frozen(register_type & reg_, const bxfactories::plugin_manifest & plugins_)
+  {
+    reg_.freeze();
+    BXFACTORIES_CHECK(!reg_.has("testing::shapes::square"));
+    BXFACTORIES_CHECK(reg_.find("testing::shapes::triangle") == nullptr);
+    BXFACTORIES_CHECK(!plugins_.is_loaded("testing::shapes::square"));
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  std::shared_ptr<bxfactories::plugin_manifest> plugins = std::make_shared<bxfactories::plugin_manifest>();
+  plugins->load(BXFACTORIES_TEST_PLUGIN_MANIFEST);
+  plugins->add("testing::missing", "/nonexistent/libbxfactories-missing.so");
+  register_type & reg = testing::i_shape::grab_system_factory_register();
+  reg.set_plugin_manifest(plugins);
+
+  check_loaded(reg, *plugins);
+  // The objects of the plugin are destroyed: the classes are unregistered with the library.
+  plugins->unload();
+  BXFACTORIES_CHECK(!plugins->is_loaded("testing::shapes::square"));
+  BXFACTORIES_CHECK(registered_ids().empty());
+  // The next lookup loads the library again:
+  check_loaded(reg, *plugins);
+  plugins->unload();
+  BXFACTORIES_CHECK(registered_ids().empty());
+  check_failed_lookup(reg, *plugins);
+  check_failed_library(reg, *plugins);
+  check_rejected_manifest(plugins);
+  check_frozen(reg, *plugins);
+  return bxfactories_testing::status();
+}
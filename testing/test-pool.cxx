@@ -0,0 +1,225 @@
+// Pooled creation of objects: storage reuse, recycling and alignment
+
+// Standard Library:
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// This project:
+#include <bxfactories/factory_pool.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  std::atomic<int> alive{0};
+  std::atomic<int> constructions{0};
+  std::atomic<int> resets{0};
+
+  struct base
+  {
+    base() { alive++; }
+    virtual ~base() { alive--; }
+    virtual int value() const = 0;
+  };
+
+  struct counter : public base
+  {
+    explicit counter(int value_) : _value_(value_) { constructions++; }
+    int value() const override { return _value_; }
+    int _value_;
+  };
+
+  void reset_counter(base & object_, int && value_)
+  {
+    resets++;
+    if (value_ < 0) throw std::runtime_error("Cannot reset a counter to a negative value");
+    static_cast<counter &>(object_)._value_ = value_;
+    return;
+  }
+
+  /// An over-aligned class
+  struct alignas(64) aligned : public base
+  {
+    explicit aligned(int value_) : _value_(value_) {}
+    int value() const override { return _value_; }
+    int _value_;
+  };
+
+  /// A class whose base subobject is not at the start of the object
+  struct mixin
+  {
+    virtual ~mixin() = default;
+    double weight = 1.0;
+  };
+
+  struct mixed : public mixin, public base
+  {
+    explicit mixed(int value_) : _value_(value_) {}
+    int value() const override { return _value_; }
+    int _value_;
+  };
+
+  typedef bxfactories::factory_register<base, int> register_type;
+  typedef bxfactories::factory_pool<base, int> pool_type;
+
+  void fill(register_type & reg_)
+  {
+    reg_.register_factory<counter>("testing::counter");
+    reg_.register_factory<aligned>("testing::aligned");
+    reg_.register_factory<mixed>("testing::mixed");
+    // A class with no known layout, allocated by its factory:
+    reg_.register_factory("testing::bare",
+                          register_type::factory_type([](int value_) -> base * { return new counter(value_); }),
+                          typeid(counter));
+    return;
+  }
+
+  void test_storage_reuse()
+  {
+    register_type reg("pool");
+    fill(reg);
+    {
+      pool_type pool(reg);
+      for (const char * id : {"testing::counter", "testing::aligned", "testing::mixed", "testing::bare"}) {
+        const void * address = nullptr;
+        {
+          pool_type::pointer_type object = pool.create(id, 3);
+          BXFACTORIES_CHECK(object && object->value() == 3);
+          address = object.get();
+        }
+        BXFACTORIES_CHECK(alive == 0);
+        // Without a reset hook, released objects are destroyed and their storage is reused:
+        pool_type::pointer_type object = pool.create(id, 4);
+        BXFACTORIES_CHECK(object && object->value() == 4);
+        if (std::string(id) != "testing::bare") BXFACTORIES_CHECK(object.get() == address);
+      }
+    }
+    BXFACTORIES_CHECK(alive == 0);
+    return;
+  }
+
+  void test_recycling()
+  {
+    register_type reg("pool");
+    fill(reg);
+    {
+      pool_type pool(reg);
+      pool.set_reset_hook("testing::counter", &reset_counter);
+      constructions = resets = 0;
+      const void * address = nullptr;
+      {
+        pool_type::pointer_type object = pool.create("testing::counter", 1);
+        address = object.get();
+      }
+      // The released object is kept alive, and reset by the next creation:
+      BXFACTORIES_CHECK(alive == 1);
+      pool_type::pointer_type object = pool.create("testing::counter", 2);
+      BXFACTORIES_CHECK(object.get() == address && object->value() == 2);
+      BXFACTORIES_CHECK(constructions == 1 && resets == 1);
+      object.reset();
+      // An object which cannot be reset is destroyed:
+      BXFACTORIES_CHECK_THROW(pool.create("testing::counter", -1), std::runtime_error);
+      BXFACTORIES_CHECK(alive == 0 && resets == 2);
+      // Removing the hook destroys the recycled objects:
+      pool.create("testing::counter", 5).reset();
+      BXFACTORIES_CHECK(alive == 1);
+      pool.set_reset_hook("testing::counter", nullptr);
+      BXFACTORIES_CHECK(alive == 0);
+      pool.create("testing::counter", 6).reset();
+      BXFACTORIES_CHECK(alive == 0);
+      // Recycled objects are destroyed with the pool:
+      pool.set_reset_hook("testing::bare", &reset_counter);
+      pool.create("testing::bare", 7).reset();
+      BXFACTORIES_CHECK(alive == 1);
+    }
+    BXFACTORIES_CHECK(alive == 0);
+    return;
+  }
+
+  void test_alignment()
+  {
+    register_type reg("pool");
+    fill(reg);
+    {
+      pool_type pool(reg);
+      std::vector<pool_type::pointer_type> objects;
+      for (int i = 0; i < 100; i++) {
+        objects.push_back(pool.create("testing::aligned", i));
+        objects.push_back(pool.create("testing::mixed", i));
+      }
+      int good = 0;
+      for (std::size_t i = 0; i < objects.size(); i += 2) {
+        const aligned * a = dynamic_cast<const aligned *>(objects[i].get());
+        const mixed * m = dynamic_cast<const mixed *>(objects[i + 1].get());
+        if (a == nullptr || m == nullptr) continue;
+        if (reinterpret_cast<std::uintptr_t>(a) % 64 != 0) continue;
+        if (reinterpret_cast<std::uintptr_t>(m) % alignof(mixed) != 0) continue;
+        if (a->value() == static_cast<int>(i / 2) && m->value() == static_cast<int>(i / 2) && m->weight == 1.0) good++;
+      }
+      BXFACTORIES_CHECK(good == 100);
+    }
+    BXFACTORIES_CHECK(alive == 0);
+    return;
+  }
+
+  void test_errors()
+  {
+    register_type reg("pool");
+    fill(reg);
+    pool_type pool(reg);
+    BXFACTORIES_CHECK_THROW(pool.create("testing::unknown", 1), std::logic_error);
+    BXFACTORIES_CHECK_THROW(pool.set_reset_hook("testing::unknown", &reset_counter), std::logic_error);
+    const register_type::factory_handle_type handle = reg.resolve("testing::counter");
+    pool_type::pointer_type object = pool.create(handle, 1);
+    // Objects outlive the unregistration of their class:
+    reg.unregister_factory("testing::counter");
+    BXFACTORIES_CHECK_THROW(pool.create(handle, 1), std::logic_error);
+    BXFACTORIES_CHECK(object->value() == 1);
+    reg.register_factory<aligned>("testing::counter");
+    pool_type::pointer_type other = pool.create("testing::counter", 2);
+    BXFACTORIES_CHECK(dynamic_cast<aligned *>(other.get()) != nullptr);
+    object.reset();
+    other.reset();
+    BXFACTORIES_CHECK(alive == 0);
+    return;
+  }
+
+  void test_shared()
+  {
+    register_type reg("pool");
+    fill(reg);
+    pool_type pool(reg, pool_type::thread_safe);
+    pool.set_reset_hook("testing::counter", &reset_counter);
+    std::vector<std::thread> threads;
+    std::vector<int> good(4, 0);
+    for (int t = 0; t < 4; t++) {
+      threads.emplace_back([&pool, &good, t]() {
+          for (int i = 0; i < 500; i++) {
+            pool_type::pointer_type a = pool.create("testing::counter", i);
+            pool_type::pointer_type b = pool.create("testing::mixed", i);
+            if (a->value() == i && b->value() == i) good[t]++;
+          }
+          return;
+        });
+    }
+    for (std::thread & thread : threads) thread.join();
+    BXFACTORIES_CHECK(good[0] + good[1] + good[2] + good[3] == 2000);
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_storage_reuse();
+  test_recycling();
+  test_alignment();
+  test_errors();
+  test_shared();
+  BXFACTORIES_CHECK(alive == 0);
+  return bxfactories_testing::status();
+}
@@ -0,0 +1,156 @@
+// Registration of prototypes, whose copies are created by the factories
+
+// Standard Library:
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  struct base
+  {
+    virtual ~base() = default;
+    virtual int value() const = 0;
+  };
+
+  std::atomic<int> grid_constructions{0};
+
+  /// A class whose construction is expensive, copied by its copy constructor
+  struct grid : public base
+  {
+    explicit grid(int offset_)
+      : cells(1000)
+      , offset(offset_)
+    {
+      grid_constructions++;
+      for (std::size_t i = 0; i < cells.size(); i++) cells[i] = static_cast<int>(i);
+    }
+
+    grid(const grid &) = default;
+
+    int value() const override { return offset + cells[10]; }
+
+    std::vector<int> cells;
+    int offset = 0;
+  };
+
+  /// A class derived from grid
+  struct fine_grid : public grid
+  {
+    fine_grid() : grid(100) {}
+
+    int value() const override { return -1; }
+  };
+
+  std::atomic<int> clones{0};
+
+  /// A class copied by its clone() method
+  struct shape : public base
+  {
+    virtual shape * clone() const
+    {
+      clones++;
+      return new shape(*this);
+    }
+
+    int value() const override { return 1; }
+  };
+
+  /// A class derived from shape, which overrides clone()
+  struct square : public shape
+  {
+    square * clone() const override
+    {
+      clones++;
+      return new square(*this);
+    }
+
+    int value() const override { return 4; }
+  };
+
+  typedef bxfactories::factory_register<base> register_type;
+
+  void test_copy_constructor()
+  {
+    register_type reg("prototypes");
+    reg.register_prototype("testing::grid", std::make_shared<const grid>(7), "A grid", "grids");
+    BXFACTORIES_CHECK(grid_constructions.load() == 1);
+    std::unique_ptr<base> object(reg.try_create("testing::grid"));
+    BXFACTORIES_CHECK(object && object->value() == 17);
+    BXFACTORIES_CHECK(dynamic_cast<grid *>(object.get()) != nullptr);
+    std::string id;
+    BXFACTORIES_CHECK(reg.fetch_type_id<grid>(id) && id == "testing::grid");
+    // Copies of the register share the prototype:
+    register_type copy(reg);
+    std::unique_ptr<base> copied(copy.get("testing::grid")());
+    BXFACTORIES_CHECK(copied && copied->value() == 17);
+    BXFACTORIES_CHECK(grid_constructions.load() == 1);
+    return;
+  }
+
+  void test_clone()
+  {
+    register_type reg("prototypes");
+    reg.register_prototype("testing::shape", std::make_shared<const shape>());
+    // A prototype of a derived class is copied by its clone() method, and registered with its dynamic type:
+    std::shared_ptr<const shape> prototype = std::make_shared<const square>();
+    reg.register_prototype("testing::square", prototype);
+    clones = 0;
+    std::unique_ptr<base> object(reg.try_create("testing::square"));
+    BXFACTORIES_CHECK(object && object->value() == 4);
+    BXFACTORIES_CHECK(clones.load() == 1);
+    std::string id;
+    BXFACTORIES_CHECK(reg.fetch_type_id<square>(id) && id == "testing::square");
+    BXFACTORIES_CHECK(reg.fetch_type_id<shape>(id) && id == "testing::shape");
+    return;
+  }
+
+  void test_rejected()
+  {
+    register_type reg("prototypes");
+    BXFACTORIES_CHECK_THROW(reg.register_prototype("testing::null", std::shared_ptr<const grid>()), std::logic_error);
+    // A prototype of a derived class would be sliced by the copy constructor:
+    std::shared_ptr<const grid> sliced = std::make_shared<const fine_grid>();
+    BXFACTORIES_CHECK_THROW(reg.register_prototype("testing::fine_grid", sliced), std::logic_error);
+    BXFACTORIES_CHECK(reg.size() == 0);
+    return;
+  }
+
+  void test_concurrent_copies()
+  {
+    register_type reg("prototypes");
+    reg.register_prototype("testing::grid", std::make_shared<const grid>(1));
+    const register_type::factory_handle_type handle = reg.resolve("testing::grid");
+    std::atomic<int> good{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+      threads.emplace_back([&]() {
+          for (int i = 0; i < 200; i++) {
+            std::unique_ptr<base> object(reg.create(handle));
+            if (object->value() == 11) good++;
+          }
+          return;
+        });
+    }
+    for (std::thread & thread : threads) thread.join();
+    BXFACTORIES_CHECK(good.load() == 800);
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_copy_constructor();
+  test_clone();
+  test_rejected();
+  test_concurrent_copies();
+  return bxfactories_testing::status();
+}
@@ -0,0 +1,148 @@
+// Enumeration of the records of a register: snapshots and locked views
+
+// Standard Library:
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  struct base
+  {
+    virtual ~base() = default;
+  };
+
+  struct object : public base
+  {
+  };
+
+  typedef bxfactories::factory_register<base> register_type;
+
+  /// Fill a register
+  void fill(register_type & reg_)
+  {
+    reg_.register_factory<object>("shape::square", "", "shape");
+    reg_.register_factory<object>("color::red", "", "color");
+    reg_.register_factory<object>("shape::disk", "", "shape");
+    reg_.register_factory<object>("color::blue", "", "color");
+    reg_.register_factory<object>("shapes", "", "misc");
+    return;
+  }
+
+  /// Return the IDs of a range of records, in order
+  template <class Range>
+  std::vector<std::string> ids_of(const Range & range_)
+  {
+    std::vector<std::string> ids;
+    for (const register_type::factory_record_type & record : range_) {
+      ids.push_back(std::string(record.type_id.data(), record.type_id.size()));
+    }
+    return ids;
+  }
+
+  void test_views()
+  {
+    register_type reg("views");
+    fill(reg);
+    const std::uint64_t version = reg.get_version();
+    {
+      const std::vector<std::string> ids = ids_of(reg.lock_records());
+      BXFACTORIES_CHECK(ids.size() == 5);
+      BXFACTORIES_CHECK(ids.front() == "color::blue" && ids.back() == "shapes");
+    }
+    {
+      register_type::prefix_view_type view = reg.lock_records_with_prefix("shape::");
+      BXFACTORIES_CHECK(view.size() == 2);
+      const std::vector<std::string> ids = ids_of(view);
+      BXFACTORIES_CHECK(ids.size() == 2 && ids[0] == "shape::disk" && ids[1] == "shape::square");
+    }
+    BXFACTORIES_CHECK(reg.lock_records_with_prefix("shape").size() == 3);
+    BXFACTORIES_CHECK(reg.lock_records_with_prefix("").size() == 5);
+    BXFACTORIES_CHECK(reg.lock_records_with_prefix("texture").empty());
+    BXFACTORIES_CHECK(ids_of(reg.lock_records_in_category("color")).size() == 2);
+    BXFACTORIES_CHECK(reg.lock_records_in_category("none").empty());
+    // Views do not modify the register:
+    BXFACTORIES_CHECK(reg.get_version() == version);
+    return;
+  }
+
+  void test_snapshots()
+  {
+    register_type reg("snapshots");
+    fill(reg);
+    register_type copy("copy");
+    const register_type::record_snapshot_type snapshot = reg.records();
+    BXFACTORIES_CHECK(snapshot.size() == 5);
+    BXFACTORIES_CHECK(ids_of(snapshot) == ids_of(reg.lock_records()));
+    // The register may be used, and modified, while a snapshot is walked:
+    std::size_t walked = 0;
+    for (const register_type::factory_record_type & record : snapshot) {
+      const std::string id(record.type_id.data(), record.type_id.size());
+      std::ostringstream out;
+      reg.print(out);
+      std::set<std::string> ids;
+      reg.list_of_factory_ids(ids);
+      BXFACTORIES_CHECK(ids.count(id) == 1);
+      BXFACTORIES_CHECK(reg.records_in_category(std::string(record.category.data(), record.category.size())).size() >= 1);
+      std::set<std::string> selected;
+      selected.insert(id);
+      copy.import_some(reg, selected);
+      reg.unregister_factory(id);
+      walked++;
+    }
+    BXFACTORIES_CHECK(walked == 5);
+    BXFACTORIES_CHECK(reg.size() == 0);
+    BXFACTORIES_CHECK(copy.size() == 5);
+    // Records of unregistered factories are still listed by the snapshot:
+    BXFACTORIES_CHECK(ids_of(snapshot).size() == 5);
+    BXFACTORIES_CHECK(reg.records().empty());
+    BXFACTORIES_CHECK(copy.records_with_prefix("color::").size() == 2);
+    BXFACTORIES_CHECK(copy.records_in_category("shape").size() == 2);
+    return;
+  }
+
+  void test_size_and_version()
+  {
+    register_type reg("version");
+    BXFACTORIES_CHECK(reg.size() == 0 && reg.records().empty());
+    std::uint64_t version = reg.get_version();
+    fill(reg);
+    BXFACTORIES_CHECK(reg.size() == 5 && reg.records().size() == 5);
+    BXFACTORIES_CHECK(reg.get_version() > version);
+    version = reg.get_version();
+    // Records refer to the IDs owned by the register, which are not copied:
+    for (const register_type::factory_record_type & record : reg.records()) {
+      BXFACTORIES_CHECK(record.type_id.data() == reg.find(record.type_id)->type_id.data());
+    }
+    // Lookups, creations and enumerations leave the version unchanged:
+    std::unique_ptr<base> created(reg.try_create("color::red"));
+    BXFACTORIES_CHECK(created && reg.has("shapes") && reg.records_with_prefix("color::").size() == 2);
+    BXFACTORIES_CHECK(reg.get_version() == version);
+    // Each (un)registration changes it:
+    reg.unregister_factory("shapes");
+    BXFACTORIES_CHECK(reg.size() == 4 && reg.get_version() > version);
+    version = reg.get_version();
+    reg.register_factory<object>("shapes", "", "misc");
+    BXFACTORIES_CHECK(reg.size() == 5 && reg.get_version() > version);
+    version = reg.get_version();
+    reg.clear();
+    BXFACTORIES_CHECK(reg.size() == 0 && reg.records().empty() && reg.get_version() > version);
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_views();
+  test_snapshots();
+  test_size_and_version();
+  return bxfactories_testing::status();
+}
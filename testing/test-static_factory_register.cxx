@@ -0,0 +1,108 @@
+// Factory register of a closed set of classes known at compile time
+
+// Standard Library:
+#include <memory>
+#include <set>
+#include <string>
+
+// This project:
+#include <bxfactories/static_factory_register.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  struct base
+  {
+    explicit base(const std::string & name_ = "") : name(name_) {}
+    virtual ~base() = default;
+    virtual int value() const = 0;
+    std::string name;
+  };
+
+  struct foo : public base
+  {
+    explicit foo(const std::string & name_ = "") : base(name_) {}
+    int value() const override { return 1; }
+  };
+
+  struct bar : public base
+  {
+    explicit bar(const std::string & name_ = "") : base(name_) {}
+    int value() const override { return 2; }
+  };
+
+  struct unregistered : public base
+  {
+    int value() const override { return 0; }
+  };
+
+  BXFACTORIES_STATIC_FACTORY_ENTRY(foo_entry, foo, "testing::foo")
+  BXFACTORIES_STATIC_FACTORY_ENTRY(bar_entry, bar, "testing::bar")
+
+  typedef bxfactories::static_factory_register<base, foo_entry, bar_entry> register_type;
+  typedef bxfactories::static_factory_register<base * (const std::string &), foo_entry, bar_entry> register_args_type;
+
+  // IDs and classes are resolved at compile time:
+  static_assert(register_type::size() == 2, "size");
+  static_assert(register_type::index_of("testing::bar") == 1, "index_of");
+  static_assert(register_type::index_of("testing::baz") == register_type::npos, "index_of unknown");
+  static_assert(register_type::index_of_type<foo>() == 0, "index_of_type");
+  static_assert(register_type::index_of_type<unregistered>() == register_type::npos, "index_of_type unknown");
+
+  void test_lookup()
+  {
+    const register_type reg;
+    BXFACTORIES_CHECK(reg.has("testing::foo"));
+    BXFACTORIES_CHECK(!reg.has("testing::baz"));
+    BXFACTORIES_CHECK(!reg.has("testing::fo"));
+    BXFACTORIES_CHECK(register_type::find_index("testing::bar") == 1);
+    BXFACTORIES_CHECK(reg.try_get("testing::baz") == nullptr);
+    BXFACTORIES_CHECK(std::string(register_type::id_at(0)) == "testing::foo");
+    std::unique_ptr<base> object(reg.try_create("testing::bar"));
+    BXFACTORIES_CHECK(object && object->value() == 2);
+    BXFACTORIES_CHECK(reg.try_create("testing::baz") == nullptr);
+    std::unique_ptr<base> by_index(reg.create(0));
+    BXFACTORIES_CHECK(by_index && by_index->value() == 1);
+    std::unique_ptr<base> direct(register_type::create<register_type::index_of("testing::bar")>());
+    BXFACTORIES_CHECK(direct && direct->value() == 2);
+    std::set<std::string> ids;
+    reg.list_of_factory_ids(ids);
+    BXFACTORIES_CHECK(ids.size() == 2 && ids.count("testing::foo") == 1);
+    std::string id;
+    BXFACTORIES_CHECK(reg.fetch_type_id<bar>(id) && id == "testing::bar");
+    BXFACTORIES_CHECK(!reg.fetch_type_id<unregistered>(id));
+    return;
+  }
+
+  void test_arguments()
+  {
+    const register_args_type reg;
+    std::unique_ptr<base> object(reg.try_create("testing::foo", "named"));
+    BXFACTORIES_CHECK(object && object->value() == 1 && object->name == "named");
+    std::unique_ptr<base> direct(register_args_type::create<1>("direct"));
+    BXFACTORIES_CHECK(direct && direct->value() == 2 && direct->name == "direct");
+    return;
+  }
+
+  void test_export()
+  {
+    register_type::register_type runtime("runtime");
+    const register_type reg;
+    reg.export_factories(runtime);
+    BXFACTORIES_CHECK(runtime.size() == 2);
+    std::unique_ptr<base> object(runtime.try_create("testing::bar"));
+    BXFACTORIES_CHECK(object && object->value() == 2);
+    std::string id;
+    BXFACTORIES_CHECK(runtime.fetch_type_id<foo>(id) && id == "testing::foo");
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_lookup();
+  test_arguments();
+  test_export();
+  return bxfactories_testing::status();
+}
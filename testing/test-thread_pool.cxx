@@ -0,0 +1,72 @@
+// Stress of the work-stealing thread pool: many short loops from several threads
+
+// Standard Library:
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// This project:
+#include <bxfactories/thread_pool.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  /// Many short loops, so that workers often complete the last item of a loop
+  /// while its calling thread is about to return and destroy it
+  void test_short_loops()
+  {
+    bxfactories::thread_pool pool(4);
+    BXFACTORIES_CHECK(pool.size() == 4);
+    std::atomic<int> bad_sums{0};
+    std::vector<std::thread> callers;
+    for (int c = 0; c < 3; c++) {
+      callers.emplace_back([&pool, &bad_sums]() {
+          for (int loop = 0; loop < 2000; loop++) {
+            const std::size_t count = 1 + loop % 7;
+            std::vector<int> done(count, 0);
+            pool.parallel_for(count, [&done](std::size_t i_) {
+                done[i_]++;
+                return;
+              });
+            for (std::size_t i = 0; i < count; i++) {
+              if (done[i] != 1) bad_sums++;
+            }
+          }
+          return;
+        });
+    }
+    for (std::thread & caller : callers) caller.join();
+    BXFACTORIES_CHECK(bad_sums.load() == 0);
+    return;
+  }
+
+  /// Items of uneven durations are stolen by idle workers
+  void test_uneven_items()
+  {
+    bxfactories::thread_pool pool(3);
+    std::vector<long> results(64, 0);
+    pool.parallel_for(results.size(), [&results](std::size_t i_) {
+        long sum = 0;
+        const long n = i_ % 8 == 0 ? 200000 : 10;
+        for (long k = 0; k < n; k++) sum += k;
+        results[i_] = sum;
+        return;
+      });
+    for (std::size_t i = 0; i < results.size(); i++) {
+      const long n = i % 8 == 0 ? 200000 : 10;
+      BXFACTORIES_CHECK(results[i] == n * (n - 1) / 2);
+    }
+    // An empty loop returns at once:
+    pool.parallel_for(0, [](std::size_t) { return; });
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_short_loops();
+  test_uneven_items();
+  return bxfactories_testing::status();
+}
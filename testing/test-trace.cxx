@@ -0,0 +1,139 @@
+// Binary tracing of the operations on a register
+
+// Standard Library:
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// This project:
+#include <bxfactories/factory.hpp>
+#include "bxfactories_testing.hpp"
+
+namespace {
+
+  struct base
+  {
+    virtual ~base() = default;
+  };
+
+  struct object : public base
+  {
+  };
+
+  typedef bxfactories::factory_register<base> register_type;
+
+  /// Pop the next event of a buffer, and check its operation and ID
+  bool next_is(bxfactories::trace_buffer & buffer_, bxfactories::trace_operation operation_, const std::string & id_)
+  {
+    bxfactories::trace_event event;
+    if (!buffer_.pop(event)) return false;
+    return event.operation == operation_ && event.id_view() == id_ && event.label_view() == "traced";
+  }
+
+  void test_register_events()
+  {
+    using bxfactories::trace_operation;
+    std::shared_ptr<bxfactories::trace_buffer> buffer = std::make_shared<bxfactories::trace_buffer>(64);
+    register_type source("source");
+    source.register_factory<object>("testing::imported");
+    {
+      register_type reg("traced");
+      reg.set_tracer(buffer);
+      BXFACTORIES_CHECK(reg.get_tracer() == buffer);
+      reg.register_factory<object>("testing::first");
+      std::unique_ptr<base> untraced(reg.try_create("testing::first"));
+      reg.unregister_factory("testing::first");
+      reg.import(source);
+      reg.set_tracer(buffer, true);
+      std::unique_ptr<base> traced(reg.try_create("testing::imported"));
+      reg.clear();
+      reg.set_tracer(nullptr);
+      reg.register_factory<object>("testing::untraced");
+    }
+    BXFACTORIES_CHECK(next_is(*buffer, trace_operation::registered, "testing::first"));
+    BXFACTORIES_CHECK(next_is(*buffer, trace_operation::unregistered, "testing::first"));
+    BXFACTORIES_CHECK(next_is(*buffer, trace_operation::import, "source"));
+    BXFACTORIES_CHECK(next_is(*buffer, trace_operation::imported, "testing::imported"));
+    BXFACTORIES_CHECK(next_is(*buffer, trace_operation::created, "testing::imported"));
+    BXFACTORIES_CHECK(next_is(*buffer, trace_operation::cleared, "testing::imported"));
+    bxfactories::trace_event event;
+    BXFACTORIES_CHECK(!buffer->pop(event));
+    BXFACTORIES_CHECK(buffer->dropped() == 0);
+    return;
+  }
+
+  void test_buffer()
+  {
+    bxfactories::trace_buffer buffer(3);
+    BXFACTORIES_CHECK(buffer.capacity() == 4);
+    // Events are dropped when the buffer is full:
+    for (int i = 0; i < 10; i++) {
+      buffer.record(bxfactories::trace_operation::registered, "label", std::to_string(i));
+    }
+    BXFACTORIES_CHECK(buffer.dropped() == 6);
+    std::vector<std::string> ids;
+    const std::size_t ndrained = buffer.drain([&ids](const bxfactories::trace_event & event_) {
+        ids.push_back(std::string(event_.id_view().data(), event_.id_view().size()));
+        return;
+      });
+    BXFACTORIES_CHECK(ndrained == 4 && ids.size() == 4 && ids.front() == "0" && ids.back() == "3");
+    // Long labels and IDs are truncated:
+    const std::string long_id(200, 'x');
+    buffer.record(bxfactories::trace_operation::registered, "a label longer than sixteen characters", long_id);
+    bxfactories::trace_event event;
+    BXFACTORIES_CHECK(buffer.pop(event));
+    BXFACTORIES_CHECK(event.truncated());
+    BXFACTORIES_CHECK(event.id_size == 200 && event.id_view().size() == bxfactories::trace_event::max_id_size);
+    BXFACTORIES_CHECK(event.label_view().size() == bxfactories::trace_event::max_label_size);
+    return;
+  }
+
+  void test_writers()
+  {
+    const int nthreads = 4;
+    const int nevents = 2000;
+    std::shared_ptr<bxfactories::trace_buffer> buffer = std::make_shared<bxfactories::trace_buffer>(256);
+    std::atomic<int> handled{0};
+    {
+      bxfactories::trace_writer writer(buffer, [&handled](const bxfactories::trace_event &) {
+          handled++;
+          return;
+        }, std::chrono::milliseconds(1));
+      std::vector<std::thread> producers;
+      for (int t = 0; t < nthreads; t++) {
+        producers.emplace_back([&buffer]() {
+            for (int i = 0; i < nevents; i++) {
+              buffer->record(bxfactories::trace_operation::created, "producer", "testing::event");
+            }
+            return;
+          });
+      }
+      for (std::thread & producer : producers) producer.join();
+    }
+    // The writer drains the remaining events when it is destroyed, and no event is lost silently:
+    BXFACTORIES_CHECK(handled.load() + static_cast<int>(buffer->dropped()) == nthreads * nevents);
+
+    std::ostringstream out;
+    {
+      bxfactories::trace_writer writer(buffer, out);
+      register_type reg("printed");
+      reg.set_tracer(buffer);
+      reg.register_factory<object>("testing::printed");
+      writer.flush();
+      BXFACTORIES_CHECK(out.str().find("'testing::printed'") != std::string::npos);
+    }
+    return;
+  }
+
+} // end of namespace
+
+int main()
+{
+  test_register_events();
+  test_buffer();
+  test_writers();
+  return bxfactories_testing::status();
+}